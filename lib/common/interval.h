@@ -16,21 +16,24 @@
 #define FORTRAN_COMMON_INTERVAL_H_
 
 // Defines a generalized template class Interval<A> to represent
-// the half-open interval [x .. x+n).
+// the half-open interval [x .. x+n).  The type used to hold n can be
+// narrowed to save space when it is known to suffice.
 
 #include "idioms.h"
+#include <algorithm>
 #include <cstddef>
 #include <utility>
 
 namespace Fortran::common {
 
-template<typename A> class Interval {
+template<typename A, typename SIZE = std::size_t> class Interval {
 public:
   using type = A;
   constexpr Interval() {}
-  constexpr Interval(const A &s, std::size_t n = 1) : start_{s}, size_{n} {}
+  constexpr Interval(const A &s, std::size_t n = 1)
+    : start_{s}, size_{static_cast<SIZE>(n)} {}
   constexpr Interval(A &&s, std::size_t n = 1)
-    : start_{std::move(s)}, size_{n} {}
+    : start_{std::move(s)}, size_{static_cast<SIZE>(n)} {}
   constexpr Interval(const Interval &) = default;
   constexpr Interval(Interval &&) = default;
   constexpr Interval &operator=(const Interval &) = default;
@@ -48,10 +51,10 @@ public:
   constexpr bool empty() const { return size_ == 0; }
 
   constexpr bool Contains(const A &x) const {
-    return start_ <= x && x < start_ + size_;
+    return start_ <= x && x < start_ + size();
   }
   constexpr bool Contains(const Interval &that) const {
-    return Contains(that.start_) && Contains(that.start_ + (that.size_ - 1));
+    return Contains(that.start_) && Contains(that.start_ + (that.size() - 1));
   }
   constexpr bool IsDisjointWith(const Interval &that) const {
     return that.NextAfter() <= start_ || NextAfter() <= that.start_;
@@ -60,7 +63,7 @@ public:
     return NextAfter() == that.start_;
   }
   void Annex(const Interval &that) {
-    size_ = (that.start_ + that.size_) - start_;
+    size_ = static_cast<SIZE>((that.start_ + that.size()) - start_);
   }
   bool AnnexIfPredecessor(const Interval &that) {
     if (ImmediatelyPrecedes(that)) {
@@ -79,14 +82,14 @@ public:
     return start_ + n;
   }
 
-  constexpr A Last() const { return start_ + (size_ - 1); }
-  constexpr A NextAfter() const { return start_ + size_; }
+  constexpr A Last() const { return start_ + (size() - 1); }
+  constexpr A NextAfter() const { return start_ + size(); }
   constexpr Interval Prefix(std::size_t n) const {
-    return {start_, std::min(size_, n)};
+    return {start_, std::min(size(), n)};
   }
   Interval Suffix(std::size_t n) const {
     CHECK(n <= size_);
-    return {start_ + n, size_ - n};
+    return {start_ + n, size() - n};
   }
 
   constexpr Interval Intersection(const Interval &that) const {
@@ -94,18 +97,18 @@ public:
       return {};
     } else if (start_ >= that.start_) {
       auto skip{start_ - that.start_};
-      return {start_, std::min(size_, that.size_ - skip)};
+      return {start_, std::min(size(), that.size() - skip)};
     } else if (NextAfter() <= that.start_) {
       return {};
     } else {
       auto skip{that.start_ - start_};
-      return {that.start_, std::min(that.size_ - size_ - skip)};
+      return {that.start_, std::min(that.size(), size() - skip)};
     }
   }
 
 private:
   A start_;
-  std::size_t size_{0};
+  SIZE size_{0};
 };
 }
 #endif  // FORTRAN_COMMON_INTERVAL_H_
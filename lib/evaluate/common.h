@@ -21,6 +21,7 @@
 #include "../common/indirection.h"
 #include "../parser/message.h"
 #include <cinttypes>
+#include <map>
 
 namespace Fortran::evaluate {
 
@@ -170,23 +171,30 @@ template<typename A> using CopyableIndirection = common::Indirection<A, true>;
 // definition
 template<typename A> class Expr;
 
+class FoldCache;
+
 struct FoldingContext {
   explicit FoldingContext(const parser::ContextualMessages &m,
       Rounding round = defaultRounding, bool flush = false)
     : messages{m}, rounding{round}, flushDenormalsToZero{flush} {}
   FoldingContext(const parser::ContextualMessages &m, const FoldingContext &c)
-    : messages{m}, rounding{c.rounding}, flushDenormalsToZero{
-                                             c.flushDenormalsToZero} {}
+    : messages{m}, rounding{c.rounding},
+      flushDenormalsToZero{c.flushDenormalsToZero}, cache{c.cache} {}
 
   // For narrowed contexts
   FoldingContext(const FoldingContext &c, const parser::ContextualMessages &m)
-    : messages{m}, rounding{c.rounding}, flushDenormalsToZero{
-                                             c.flushDenormalsToZero} {}
+    : messages{m}, rounding{c.rounding},
+      flushDenormalsToZero{c.flushDenormalsToZero}, cache{c.cache} {}
 
   parser::ContextualMessages messages;
   Rounding rounding{defaultRounding};
   bool flushDenormalsToZero{false};
   bool bigEndian{false};
+  // Current values of the indices of the implied DO loops being unrolled
+  // while folding array constructors
+  std::map<parser::CharBlock, std::int64_t> impliedDos;
+  // Optional memo of previously folded expressions (see fold.h)
+  FoldCache *cache{nullptr};
 };
 
 void RealFlagWarnings(FoldingContext &, const RealFlags &, const char *op);
@@ -83,7 +83,7 @@ std::ostream &LogicalOperation<KIND>::Infix(std::ostream &o) const {
 }
 
 template<typename T>
-std::ostream &Constant<T>::AsFortran(std::ostream &o) const {
+std::ostream &EmitScalar(std::ostream &o, const Scalar<T> &value) {
   if constexpr (T::category == TypeCategory::Integer) {
     return o << value.SignedDecimal() << '_' << T::kind;
   } else if constexpr (T::category == TypeCategory::Real ||
@@ -97,12 +97,41 @@ std::ostream &Constant<T>::AsFortran(std::ostream &o) const {
     } else {
       o << ".false.";
     }
-    return o << '_' << Result::kind;
+    return o << '_' << T::kind;
   } else {
     return value.u.AsFortran(o);
   }
 }
 
+template<typename T>
+std::ostream &Constant<T>::AsFortran(std::ostream &o) const {
+  if (shape.empty()) {
+    return EmitScalar<T>(o, values.front());
+  }
+  if (shape.size() > 1) {
+    o << "reshape(";
+  }
+  char separator{'['};
+  for (const auto &value : values) {
+    EmitScalar<T>(o << separator, value);
+    separator = ',';
+  }
+  if (values.empty()) {
+    o << '[' << GetType().AsFortran() << "::";
+  }
+  o << ']';
+  if (shape.size() > 1) {
+    o << ",shape=";
+    separator = '[';
+    for (auto extent : shape) {
+      o << separator << extent << "_8";
+      separator = ',';
+    }
+    o << "])";
+  }
+  return o;
+}
+
 template<typename T>
 std::ostream &Emit(std::ostream &o, const CopyableIndirection<Expr<T>> &expr) {
   return expr->AsFortran(o);
@@ -162,8 +191,10 @@ template<int KIND>
 Expr<SubscriptInteger> Expr<Type<TypeCategory::Character, KIND>>::LEN() const {
   return std::visit(
       common::visitors{[](const Constant<Result> &c) {
-                         return AsExpr(
-                             Constant<SubscriptInteger>{c.value.size()});
+                         // all elements of an array constant have the same
+                         // length
+                         return AsExpr(Constant<SubscriptInteger>{
+                             c.values.empty() ? 0 : c.values.front().size()});
                        },
           [](const ArrayConstructor<Result> &a) { return a.LEN(); },
           [](const Parentheses<Result> &x) { return x.left().LEN(); },
@@ -219,6 +250,7 @@ template<typename A> int ExpressionBase<A>::Rank() const {
 // Template instantiations to resolve the "extern template" declarations
 // that appear in expression.h.
 
+FOR_EACH_INTRINSIC_KIND(template struct Constant)
 FOR_EACH_INTRINSIC_KIND(template class Expr)
 FOR_EACH_CATEGORY_TYPE(template class Expr)
 FOR_EACH_INTEGER_KIND(template struct Relational)
@@ -380,6 +380,18 @@ struct LogicalOperation
 
 // Array constructors
 
+// A reference to the index variable of an implied DO loop in an array
+// constructor.  These are always of the subscript integer type; references
+// of other kinds are wrapped in conversions.
+struct ImpliedDoIndex {
+  using Result = SubscriptInteger;
+  static constexpr int Rank() { return 0; }
+  std::ostream &AsFortran(std::ostream &o) const {
+    return o << name.ToString();
+  }
+  parser::CharBlock name;  // nested implied DOs must have distinct names
+};
+
 template<typename RESULT> struct ArrayConstructorValues;
 
 template<typename VALUES, typename OPERAND> struct ImpliedDo {
@@ -404,7 +416,8 @@ template<typename RESULT> struct ArrayConstructorValue {
 
 template<typename RESULT> struct ArrayConstructorValues {
   using Result = RESULT;
-  CLASS_BOILERPLATE(ArrayConstructorValues)
+  DEFAULT_CONSTRUCTORS_AND_ASSIGNMENTS(ArrayConstructorValues)
+  ArrayConstructorValues() {}
   template<typename A> void Push(A &&x) { values.emplace_back(std::move(x)); }
   std::vector<ArrayConstructorValue<Result>> values;
 };
@@ -443,11 +456,13 @@ private:
   using Operations = std::variant<Parentheses<Result>, Negate<Result>,
       Add<Result>, Subtract<Result>, Multiply<Result>, Divide<Result>,
       Power<Result>, Extremum<Result>>;
+  using Indices = std::conditional_t<KIND == ImpliedDoIndex::Result::kind,
+      std::variant<ImpliedDoIndex>, std::variant<>>;
   using Others = std::variant<Constant<Result>, ArrayConstructor<Result>,
       Designator<Result>, FunctionRef<Result>>;
 
 public:
-  common::CombineVariants<Operations, Conversions, Others> u;
+  common::CombineVariants<Operations, Conversions, Indices, Others> u;
 };
 
 template<int KIND>
@@ -20,8 +20,12 @@
 #include "type.h"
 #include "../common/indirection.h"
 #include "../parser/message.h"
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <optional>
+#include <ostream>
 #include <type_traits>
 #include <variant>
 
@@ -33,6 +37,17 @@ Expr<ResultType<A>> FoldOperation(FoldingContext &, A &&x) {
   return Expr<ResultType<A>>{std::move(x)};
 }
 
+// Extracts a constant of any rank from a folded expression.
+template<typename T> const Constant<T> *UnwrapConstant(const Expr<T> &expr) {
+  if (const auto *c{std::get_if<Constant<T>>(&expr.u)}) {
+    return c;
+  } else if (const auto *p{std::get_if<Parentheses<T>>(&expr.u)}) {
+    return UnwrapConstant(p->left());
+  } else {
+    return nullptr;
+  }
+}
+
 // Designators
 // At the moment, only substrings fold.
 // TODO: Parameters, KIND type parameters
@@ -57,7 +72,260 @@ Expr<Type<TypeCategory::Character, KIND>> FoldOperation(FoldingContext &context,
   return Expr<CHAR>{std::move(designator)};
 }
 
-// TODO: Fold/rewrite intrinsic function references
+// Array constructors
+// An array constructor whose values and implied DO loop bounds all fold
+// to constants is unrolled into a rank-1 constant array, unless it would
+// have more than maxElements elements or run more than that many implied
+// DO loop iterations in all.
+template<typename T> class ArrayConstructorFolder {
+public:
+  explicit ArrayConstructorFolder(FoldingContext &c) : context_{c} {}
+
+  Expr<T> FoldArray(ArrayConstructor<T> &&array) {
+    if (FoldValues(array) && FoldLength(array)) {
+      auto n{static_cast<ConstantSubscript>(elements_.size())};
+      return Expr<T>{Constant<T>{std::move(elements_), ConstantSubscripts{n}}};
+    }
+    return Expr<T>{std::move(array)};
+  }
+
+private:
+  static constexpr std::size_t maxElements{1000000};
+
+  bool FoldValues(const ArrayConstructorValues<T> &values) {
+    for (const auto &value : values.values) {
+      if (!std::visit([&](const auto &x) { return FoldValue(x); }, value.u)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool FoldValue(const CopyableIndirection<Expr<T>> &expr) {
+    // Implied DO loop bodies are folded once per iteration, so fold a copy.
+    Expr<T> folded{Fold(context_, Expr<T>{*expr})};
+    if (const Constant<T> *c{UnwrapConstant(folded)}) {
+      if (c->size() > maxElements - elements_.size()) {
+        TooLarge();
+        return false;
+      }
+      elements_.insert(elements_.end(), c->values.begin(), c->values.end());
+      return true;
+    }
+    return false;
+  }
+
+  template<typename INT>
+  bool FoldValue(const ImpliedDo<ArrayConstructorValues<T>, INT> &iDo) {
+    auto lower{ToInt64(Fold(context_, Expr<INT>{*iDo.lower}))};
+    auto upper{ToInt64(Fold(context_, Expr<INT>{*iDo.upper}))};
+    auto stride{ToInt64(Fold(context_, Expr<INT>{*iDo.stride}))};
+    if (!lower.has_value() || !upper.has_value() || !stride.has_value()) {
+      return false;
+    }
+    if (*stride == 0) {
+      context_.messages.Say("implied DO loop stride is zero"_err_en_US);
+      return false;
+    }
+    const parser::CharBlock &name{iDo.controlVariableName};
+    if (context_.impliedDos.find(name) != context_.impliedDos.end()) {
+      return false;  // nested implied DO loops with the same index
+    }
+    // Count the iterations before unrolling any; the index is computed
+    // from the count so that it can't overflow after the last one.
+    std::uint64_t trips{0};
+    if (*stride > 0 ? *lower <= *upper : *lower >= *upper) {
+      std::uint64_t span{static_cast<std::uint64_t>(*upper) -
+          static_cast<std::uint64_t>(*lower)};
+      std::uint64_t step{static_cast<std::uint64_t>(*stride)};
+      if (*stride < 0) {
+        span = -span;
+        step = -step;
+      }
+      if (span / step >= maxElements - iterations_) {
+        TooLarge();
+        return false;
+      }
+      trips = span / step + 1;
+      iterations_ += trips;
+    }
+    bool result{true};
+    for (std::uint64_t k{0}; k < trips; ++k) {
+      context_.impliedDos[name] = static_cast<std::int64_t>(
+          static_cast<std::uint64_t>(*lower) +
+          k * static_cast<std::uint64_t>(*stride));
+      if (!FoldValues(*iDo.values)) {
+        result = false;
+        break;
+      }
+    }
+    context_.impliedDos.erase(name);
+    return result;
+  }
+
+  void TooLarge() {
+    context_.messages.Say("array constructor is too large to fold"_en_US);
+  }
+
+  // CHARACTER elements are padded or truncated to the length in the
+  // type-spec, if any; otherwise they must all have the same length.
+  bool FoldLength(const ArrayConstructor<T> &array) {
+    if constexpr (T::category == TypeCategory::Character) {
+      if (!array.typeParameterValues.empty()) {
+        auto length{ToInt64(Fold(context_,
+            Expr<SubscriptInteger>{array.typeParameterValues.front()}))};
+        if (!length.has_value()) {
+          return false;
+        }
+        for (auto &element : elements_) {
+          element.resize(std::max<std::int64_t>(*length, 0), ' ');
+        }
+      } else if (elements_.empty()) {
+        return false;  // length unknown
+      } else {
+        for (const auto &element : elements_) {
+          if (element.size() != elements_.front().size()) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  FoldingContext &context_;
+  std::vector<Scalar<T>> elements_;
+  std::size_t iterations_{0};
+};
+
+template<typename T>
+Expr<T> FoldOperation(FoldingContext &context, ArrayConstructor<T> &&array) {
+  if constexpr (T::isSpecificIntrinsicType) {
+    return ArrayConstructorFolder<T>{context}.FoldArray(std::move(array));
+  } else {
+    return Expr<T>{std::move(array)};
+  }
+}
+
+Expr<SubscriptInteger> FoldOperation(
+    FoldingContext &context, ImpliedDoIndex &&iDo) {
+  auto iter{context.impliedDos.find(iDo.name)};
+  if (iter != context.impliedDos.end()) {
+    return Expr<SubscriptInteger>{Constant<SubscriptInteger>{iter->second}};
+  }
+  return Expr<SubscriptInteger>{std::move(iDo)};
+}
+
+// Elementwise folding
+// Operations fold elementwise over constant operands of any rank.  A scalar
+// operand is broadcast against an array operand; array operands must have
+// the same shape.  The per-element kernels run in tight loops over the
+// contiguous element storage of the operands, accumulating any exceptional
+// conditions so that they are reported once per operation rather than once
+// per element.
+
+template<typename TR, typename TX, typename KERNEL>
+std::optional<Expr<TR>> ApplyElementwise(const Expr<TX> &x, KERNEL &&kernel) {
+  if (const Constant<TX> *xc{UnwrapConstant(x)}) {
+    if (xc->Rank() == 0) {
+      return Expr<TR>{Constant<TR>{kernel(xc->value())}};
+    }
+    std::vector<Scalar<TR>> result(xc->size());
+    std::size_t n{result.size()};
+    const Scalar<TX> *xp{xc->values.data()};
+    Scalar<TR> *rp{result.data()};
+    for (std::size_t j{0}; j < n; ++j) {
+      rp[j] = kernel(xp[j]);
+    }
+    return Expr<TR>{
+        Constant<TR>{std::move(result), ConstantSubscripts{xc->shape}}};
+  }
+  return std::nullopt;
+}
+
+// Checks conformability and applies an array kernel that computes
+// result[j] from x[j * xStride] and y[j * yStride] for all j.
+template<typename TR, typename TX, typename TY, typename ARRAY_KERNEL>
+std::optional<Expr<TR>> ApplyToArrays(FoldingContext &context,
+    const Expr<TX> &x, const Expr<TY> &y, ARRAY_KERNEL &&arrayKernel) {
+  const Constant<TX> *xc{UnwrapConstant(x)};
+  const Constant<TY> *yc{UnwrapConstant(y)};
+  if (xc == nullptr || yc == nullptr) {
+    return std::nullopt;
+  }
+  if (xc->Rank() > 0 && yc->Rank() > 0 && xc->shape != yc->shape) {
+    context.messages.Say("array operands are not conformable"_err_en_US);
+    return std::nullopt;
+  }
+  if (xc->Rank() == 0 && yc->Rank() == 0) {
+    Scalar<TR> result;
+    arrayKernel(xc->values.data(), 0, yc->values.data(), 0, &result, 1);
+    return Expr<TR>{Constant<TR>{std::move(result)}};
+  }
+  ConstantSubscripts shape{xc->Rank() > 0 ? xc->shape : yc->shape};
+  std::vector<Scalar<TR>> result(TotalElementCount(shape));
+  arrayKernel(xc->values.data(), std::size_t{xc->Rank() > 0},
+      yc->values.data(), std::size_t{yc->Rank() > 0}, result.data(),
+      result.size());
+  return Expr<TR>{Constant<TR>{std::move(result), std::move(shape)}};
+}
+
+template<typename TR, typename TX, typename TY, typename KERNEL>
+std::optional<Expr<TR>> ApplyElementwise(FoldingContext &context,
+    const Expr<TX> &x, const Expr<TY> &y, KERNEL &&kernel) {
+  return ApplyToArrays<TR>(context, x, y,
+      [&](const Scalar<TX> *xp, std::size_t xStride, const Scalar<TY> *yp,
+          std::size_t yStride, Scalar<TR> *rp, std::size_t n) {
+        // Separate loops for broadcasts keep the strides constant.
+        if (xStride == 0) {
+          const Scalar<TX> xs{*xp};
+          for (std::size_t j{0}; j < n; ++j) {
+            rp[j] = kernel(xs, yp[j]);
+          }
+        } else if (yStride == 0) {
+          const Scalar<TY> ys{*yp};
+          for (std::size_t j{0}; j < n; ++j) {
+            rp[j] = kernel(xp[j], ys);
+          }
+        } else {
+          for (std::size_t j{0}; j < n; ++j) {
+            rp[j] = kernel(xp[j], yp[j]);
+          }
+        }
+      });
+}
+
+// REAL arithmetic uses the array operations of Real<>, which apply the
+// host's floating-point unit to whole arrays when they can.
+template<typename T, typename ARRAY_OPERATION>
+std::optional<Expr<T>> ApplyRealArrayOperation(FoldingContext &context,
+    const Expr<T> &x, const Expr<T> &y, ARRAY_OPERATION arrayOperation,
+    const char *operation) {
+  RealFlags flags;
+  auto result{ApplyToArrays<T>(context, x, y,
+      [&](const Scalar<T> *xp, std::size_t xStride, const Scalar<T> *yp,
+          std::size_t yStride, Scalar<T> *rp, std::size_t n) {
+        flags = arrayOperation(
+            xp, xStride, yp, yStride, rp, n, context.rounding);
+        if (context.flushDenormalsToZero) {
+          for (std::size_t j{0}; j < n; ++j) {
+            rp[j] = rp[j].FlushDenormalToZero();
+          }
+        }
+      })};
+  if (result.has_value()) {
+    RealFlagWarnings(context, flags, operation);
+  }
+  return result;
+}
+
+template<typename A> A FlushDenormals(const FoldingContext &context, A &&x) {
+  if (context.flushDenormalsToZero) {
+    return x.FlushDenormalToZero();
+  } else {
+    return std::move(x);
+  }
+}
 
 // Unary operations
 
@@ -69,54 +337,76 @@ Expr<TO> FoldOperation(
         kindExpr = Fold(context, std::move(kindExpr));
         using Operand = ResultType<decltype(kindExpr)>;
         char buffer[64];
-        if (auto c{GetScalarConstantValue(kindExpr)}) {
-          if constexpr (TO::category == TypeCategory::Integer) {
-            if constexpr (Operand::category == TypeCategory::Integer) {
-              auto converted{Scalar<TO>::ConvertSigned(c->value)};
-              if (converted.overflow) {
+        if constexpr (TO::category == TypeCategory::Integer) {
+          if constexpr (Operand::category == TypeCategory::Integer) {
+            bool overflow{false};
+            if (auto converted{ApplyElementwise<TO>(
+                    kindExpr, [&](const Scalar<Operand> &x) {
+                      auto result{Scalar<TO>::ConvertSigned(x)};
+                      overflow |= result.overflow;
+                      return result.value;
+                    })}) {
+              if (overflow) {
                 context.messages.Say(
                     "INTEGER(%d) to INTEGER(%d) conversion overflowed"_en_US,
                     Operand::kind, TO::kind);
               }
-              return Expr<TO>{Constant<TO>{std::move(converted.value)}};
-            } else if constexpr (Operand::category == TypeCategory::Real) {
-              auto converted{c->value.template ToInteger<Scalar<TO>>()};
-              if (converted.flags.test(RealFlag::InvalidArgument)) {
+              return std::move(*converted);
+            }
+          } else if constexpr (Operand::category == TypeCategory::Real) {
+            RealFlags flags;
+            if (auto converted{ApplyElementwise<TO>(
+                    kindExpr, [&](const Scalar<Operand> &x) {
+                      return x.template ToInteger<Scalar<TO>>()
+                          .AccumulateFlags(flags);
+                    })}) {
+              if (flags.test(RealFlag::InvalidArgument)) {
                 context.messages.Say(
                     "REAL(%d) to INTEGER(%d) conversion: invalid argument"_en_US,
                     Operand::kind, TO::kind);
-              } else if (converted.flags.test(RealFlag::Overflow)) {
+              } else if (flags.test(RealFlag::Overflow)) {
                 context.messages.Say(
                     "REAL(%d) to INTEGER(%d) conversion overflowed"_en_US,
                     Operand::kind, TO::kind);
               }
-              return Expr<TO>{Constant<TO>{std::move(converted.value)}};
+              return std::move(*converted);
             }
-          } else if constexpr (TO::category == TypeCategory::Real) {
-            if constexpr (Operand::category == TypeCategory::Integer) {
-              auto converted{Scalar<TO>::FromInteger(c->value)};
-              if (!converted.flags.empty()) {
+          }
+        } else if constexpr (TO::category == TypeCategory::Real) {
+          if constexpr (Operand::category == TypeCategory::Integer) {
+            RealFlags flags;
+            if (auto converted{ApplyElementwise<TO>(
+                    kindExpr, [&](const Scalar<Operand> &x) {
+                      return Scalar<TO>::FromInteger(x).AccumulateFlags(flags);
+                    })}) {
+              if (!flags.empty()) {
                 std::snprintf(buffer, sizeof buffer,
                     "INTEGER(%d) to REAL(%d) conversion", Operand::kind,
                     TO::kind);
-                RealFlagWarnings(context, converted.flags, buffer);
+                RealFlagWarnings(context, flags, buffer);
               }
-              return Expr<TO>{Constant<TO>{std::move(converted.value)}};
-            } else if constexpr (Operand::category == TypeCategory::Real) {
-              auto converted{Scalar<TO>::Convert(c->value)};
-              if (!converted.flags.empty()) {
+              return std::move(*converted);
+            }
+          } else if constexpr (Operand::category == TypeCategory::Real) {
+            RealFlags flags;
+            if (auto converted{ApplyElementwise<TO>(
+                    kindExpr, [&](const Scalar<Operand> &x) {
+                      return FlushDenormals(context,
+                          Scalar<TO>::Convert(x).AccumulateFlags(flags));
+                    })}) {
+              if (!flags.empty()) {
                 std::snprintf(buffer, sizeof buffer,
                     "REAL(%d) to REAL(%d) conversion", Operand::kind, TO::kind);
-                RealFlagWarnings(context, converted.flags, buffer);
-              }
-              if (context.flushDenormalsToZero) {
-                converted.value = converted.value.FlushDenormalToZero();
+                RealFlagWarnings(context, flags, buffer);
               }
-              return Expr<TO>{Constant<TO>{std::move(converted.value)}};
+              return std::move(*converted);
             }
-          } else if constexpr (TO::category == TypeCategory::Logical &&
-              Operand::category == TypeCategory::Logical) {
-            return Expr<TO>{Constant<TO>{c->value.IsTrue()}};
+          }
+        } else if constexpr (TO::category == TypeCategory::Logical &&
+            Operand::category == TypeCategory::Logical) {
+          if (auto converted{ApplyElementwise<TO>(kindExpr,
+                  [](const Scalar<Operand> &x) { return Scalar<TO>{x.IsTrue()}; })}) {
+            return std::move(*converted);
           }
         }
         return Expr<TO>{std::move(convert)};
@@ -128,9 +418,12 @@ template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Parentheses<T> &&x) {
   auto &operand{x.left()};
   operand = Fold(context, std::move(operand));
-  if (auto c{GetScalarConstantValue(operand)}) {
+  if (const Constant<T> *c{UnwrapConstant(operand)}) {
     // Preserve parentheses, even around constants.
-    return Expr<T>{Parentheses<T>{Expr<T>{Constant<T>{std::move(c->value)}}}};
+    if (!std::holds_alternative<Constant<T>>(operand.u)) {
+      Constant<T> constant{*c};
+      operand = Expr<T>{std::move(constant)};
+    }
   }
   return Expr<T>{std::move(x)};
 }
@@ -139,16 +432,23 @@ template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Negate<T> &&x) {
   auto &operand{x.left()};
   operand = Fold(context, std::move(operand));
-  if (auto c{GetScalarConstantValue(operand)}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      auto negated{c->value.Negate()};
-      if (negated.overflow) {
+  if constexpr (T::category == TypeCategory::Integer) {
+    bool overflow{false};
+    if (auto negated{ApplyElementwise<T>(operand, [&](const Scalar<T> &y) {
+          auto result{y.Negate()};
+          overflow |= result.overflow;
+          return result.value;
+        })}) {
+      if (overflow) {
         context.messages.Say("INTEGER(%d) negation overflowed"_en_US, T::kind);
       }
-      return Expr<T>{Constant<T>{std::move(negated.value)}};
-    } else {
-      // REAL & COMPLEX negation: no exceptions possible
-      return Expr<T>{Constant<T>{c->value.Negate()}};
+      return std::move(*negated);
+    }
+  } else {
+    // REAL & COMPLEX negation: no exceptions possible
+    if (auto negated{ApplyElementwise<T>(
+            operand, [](const Scalar<T> &y) { return y.Negate(); })}) {
+      return std::move(*negated);
     }
   }
   return Expr<T>{std::move(x)};
@@ -157,15 +457,15 @@ Expr<T> FoldOperation(FoldingContext &context, Negate<T> &&x) {
 template<int KIND>
 Expr<Type<TypeCategory::Real, KIND>> FoldOperation(
     FoldingContext &context, ComplexComponent<KIND> &&x) {
+  using Operand = Type<TypeCategory::Complex, KIND>;
   using Part = Type<TypeCategory::Real, KIND>;
   auto &operand{x.left()};
   operand = Fold(context, std::move(operand));
-  if (auto z{GetScalarConstantValue(operand)}) {
-    if (x.isImaginaryPart) {
-      return Expr<Part>{Constant<Part>{z->value.AIMAG()}};
-    } else {
-      return Expr<Part>{Constant<Part>{z->value.REAL()}};
-    }
+  bool isImaginaryPart{x.isImaginaryPart};
+  if (auto part{ApplyElementwise<Part>(operand, [=](const Scalar<Operand> &z) {
+        return isImaginaryPart ? z.AIMAG() : z.REAL();
+      })}) {
+    return std::move(*part);
   }
   return Expr<Part>{std::move(x)};
 }
@@ -176,8 +476,9 @@ Expr<Type<TypeCategory::Logical, KIND>> FoldOperation(
   using Ty = Type<TypeCategory::Logical, KIND>;
   auto &operand{x.left()};
   operand = Fold(context, std::move(operand));
-  if (auto c{GetScalarConstantValue(operand)}) {
-    return Expr<Ty>{Constant<Ty>{c->value.IsTrue()}};
+  if (auto result{ApplyElementwise<Ty>(operand,
+          [](const Scalar<Ty> &y) { return Scalar<Ty>{!y.IsTrue()}; })}) {
+    return std::move(*result);
   }
   return Expr<Ty>{x};
 }
@@ -185,34 +486,41 @@ Expr<Type<TypeCategory::Logical, KIND>> FoldOperation(
 // Binary (dyadic) operations
 
 template<typename T1, typename T2>
-std::optional<std::pair<Scalar<T1>, Scalar<T2>>> FoldOperands(
-    FoldingContext &context, Expr<T1> &x, Expr<T2> &y) {
+void FoldOperands(FoldingContext &context, Expr<T1> &x, Expr<T2> &y) {
   x = Fold(context, std::move(x));
   y = Fold(context, std::move(y));
-  if (auto xc{GetScalarConstantValue(x)}) {
-    if (auto yc{GetScalarConstantValue(y)}) {
-      return {std::make_pair(xc->value, yc->value)};
-    }
-  }
-  return std::nullopt;
 }
 
 template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Add<T> &&x) {
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      auto sum{folded->first.AddSigned(folded->second)};
-      if (sum.overflow) {
+  FoldOperands(context, x.left(), x.right());
+  if constexpr (T::category == TypeCategory::Integer) {
+    bool overflow{false};
+    if (auto sum{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              auto result{a.AddSigned(b)};
+              overflow |= result.overflow;
+              return result.value;
+            })}) {
+      if (overflow) {
         context.messages.Say("INTEGER(%d) addition overflowed"_en_US, T::kind);
       }
-      return Expr<T>{Constant<T>{sum.value}};
-    } else {
-      auto sum{folded->first.Add(folded->second, context.rounding)};
-      RealFlagWarnings(context, sum.flags, "addition");
-      if (context.flushDenormalsToZero) {
-        sum.value = sum.value.FlushDenormalToZero();
-      }
-      return Expr<T>{Constant<T>{sum.value}};
+      return std::move(*sum);
+    }
+  } else if constexpr (T::category == TypeCategory::Real) {
+    if (auto sum{ApplyRealArrayOperation(context, x.left(), x.right(),
+            Scalar<T>::AddElementwise, "addition")}) {
+      return std::move(*sum);
+    }
+  } else {
+    RealFlags flags;
+    if (auto sum{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              return FlushDenormals(
+                  context, a.Add(b, context.rounding).AccumulateFlags(flags));
+            })}) {
+      RealFlagWarnings(context, flags, "addition");
+      return std::move(*sum);
     }
   }
   return Expr<T>{std::move(x)};
@@ -220,21 +528,35 @@ Expr<T> FoldOperation(FoldingContext &context, Add<T> &&x) {
 
 template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Subtract<T> &&x) {
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      auto difference{folded->first.SubtractSigned(folded->second)};
-      if (difference.overflow) {
+  FoldOperands(context, x.left(), x.right());
+  if constexpr (T::category == TypeCategory::Integer) {
+    bool overflow{false};
+    if (auto difference{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              auto result{a.SubtractSigned(b)};
+              overflow |= result.overflow;
+              return result.value;
+            })}) {
+      if (overflow) {
         context.messages.Say(
             "INTEGER(%d) subtraction overflowed"_en_US, T::kind);
       }
-      return Expr<T>{Constant<T>{difference.value}};
-    } else {
-      auto difference{folded->first.Subtract(folded->second, context.rounding)};
-      RealFlagWarnings(context, difference.flags, "subtraction");
-      if (context.flushDenormalsToZero) {
-        difference.value = difference.value.FlushDenormalToZero();
-      }
-      return Expr<T>{Constant<T>{difference.value}};
+      return std::move(*difference);
+    }
+  } else if constexpr (T::category == TypeCategory::Real) {
+    if (auto difference{ApplyRealArrayOperation(context, x.left(), x.right(),
+            Scalar<T>::SubtractElementwise, "subtraction")}) {
+      return std::move(*difference);
+    }
+  } else {
+    RealFlags flags;
+    if (auto difference{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              return FlushDenormals(context,
+                  a.Subtract(b, context.rounding).AccumulateFlags(flags));
+            })}) {
+      RealFlagWarnings(context, flags, "subtraction");
+      return std::move(*difference);
     }
   }
   return Expr<T>{std::move(x)};
@@ -242,21 +564,35 @@ Expr<T> FoldOperation(FoldingContext &context, Subtract<T> &&x) {
 
 template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Multiply<T> &&x) {
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      auto product{folded->first.MultiplySigned(folded->second)};
-      if (product.SignedMultiplicationOverflowed()) {
+  FoldOperands(context, x.left(), x.right());
+  if constexpr (T::category == TypeCategory::Integer) {
+    bool overflow{false};
+    if (auto product{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              auto result{a.MultiplySigned(b)};
+              overflow |= result.SignedMultiplicationOverflowed();
+              return result.lower;
+            })}) {
+      if (overflow) {
         context.messages.Say(
             "INTEGER(%d) multiplication overflowed"_en_US, T::kind);
       }
-      return Expr<T>{Constant<T>{product.lower}};
-    } else {
-      auto product{folded->first.Multiply(folded->second, context.rounding)};
-      RealFlagWarnings(context, product.flags, "multiplication");
-      if (context.flushDenormalsToZero) {
-        product.value = product.value.FlushDenormalToZero();
-      }
-      return Expr<T>{Constant<T>{product.value}};
+      return std::move(*product);
+    }
+  } else if constexpr (T::category == TypeCategory::Real) {
+    if (auto product{ApplyRealArrayOperation(context, x.left(), x.right(),
+            Scalar<T>::MultiplyElementwise, "multiplication")}) {
+      return std::move(*product);
+    }
+  } else {
+    RealFlags flags;
+    if (auto product{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              return FlushDenormals(context,
+                  a.Multiply(b, context.rounding).AccumulateFlags(flags));
+            })}) {
+      RealFlagWarnings(context, flags, "multiplication");
+      return std::move(*product);
     }
   }
   return Expr<T>{std::move(x)};
@@ -264,23 +600,38 @@ Expr<T> FoldOperation(FoldingContext &context, Multiply<T> &&x) {
 
 template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Divide<T> &&x) {
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      auto quotAndRem{folded->first.DivideSigned(folded->second)};
-      if (quotAndRem.divisionByZero) {
+  FoldOperands(context, x.left(), x.right());
+  if constexpr (T::category == TypeCategory::Integer) {
+    bool divisionByZero{false}, overflow{false};
+    if (auto quotient{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              auto quotAndRem{a.DivideSigned(b)};
+              divisionByZero |= quotAndRem.divisionByZero;
+              overflow |= quotAndRem.overflow;
+              return quotAndRem.quotient;
+            })}) {
+      if (divisionByZero) {
         context.messages.Say("INTEGER(%d) division by zero"_en_US, T::kind);
       }
-      if (quotAndRem.overflow) {
+      if (overflow) {
         context.messages.Say("INTEGER(%d) division overflowed"_en_US, T::kind);
       }
-      return Expr<T>{Constant<T>{quotAndRem.quotient}};
-    } else {
-      auto quotient{folded->first.Divide(folded->second, context.rounding)};
-      RealFlagWarnings(context, quotient.flags, "division");
-      if (context.flushDenormalsToZero) {
-        quotient.value = quotient.value.FlushDenormalToZero();
-      }
-      return Expr<T>{Constant<T>{quotient.value}};
+      return std::move(*quotient);
+    }
+  } else if constexpr (T::category == TypeCategory::Real) {
+    if (auto quotient{ApplyRealArrayOperation(context, x.left(), x.right(),
+            Scalar<T>::DivideElementwise, "division")}) {
+      return std::move(*quotient);
+    }
+  } else {
+    RealFlags flags;
+    if (auto quotient{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              return FlushDenormals(context,
+                  a.Divide(b, context.rounding).AccumulateFlags(flags));
+            })}) {
+      RealFlagWarnings(context, flags, "division");
+      return std::move(*quotient);
     }
   }
   return Expr<T>{std::move(x)};
@@ -288,21 +639,29 @@ Expr<T> FoldOperation(FoldingContext &context, Divide<T> &&x) {
 
 template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Power<T> &&x) {
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      auto power{folded->first.Power(folded->second)};
-      if (power.divisionByZero) {
+  FoldOperands(context, x.left(), x.right());
+  if constexpr (T::category == TypeCategory::Integer) {
+    bool divisionByZero{false}, overflow{false}, zeroToZero{false};
+    if (auto power{ApplyElementwise<T>(context, x.left(), x.right(),
+            [&](const Scalar<T> &a, const Scalar<T> &b) {
+              auto result{a.Power(b)};
+              divisionByZero |= result.divisionByZero;
+              overflow |= result.overflow;
+              zeroToZero |= result.zeroToZero;
+              return result.power;
+            })}) {
+      if (divisionByZero) {
         context.messages.Say(
             "INTEGER(%d) zero to negative power"_en_US, T::kind);
-      } else if (power.overflow) {
+      } else if (overflow) {
         context.messages.Say("INTEGER(%d) power overflowed"_en_US, T::kind);
-      } else if (power.zeroToZero) {
+      } else if (zeroToZero) {
         context.messages.Say("INTEGER(%d) 0**0 is not defined"_en_US, T::kind);
       }
-      return Expr<T>{Constant<T>{power.power}};
-    } else {
-      // TODO: real & complex power with non-integral exponent
+      return std::move(*power);
     }
+  } else {
+    // TODO: real & complex power with non-integral exponent
   }
   return Expr<T>{std::move(x)};
 }
@@ -311,13 +670,16 @@ template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, RealToIntPower<T> &&x) {
   return std::visit(
       [&](auto &y) -> Expr<T> {
-        if (auto folded{FoldOperands(context, x.left(), y)}) {
-          auto power{evaluate::IntPower(folded->first, folded->second)};
-          RealFlagWarnings(context, power.flags, "power with INTEGER exponent");
-          if (context.flushDenormalsToZero) {
-            power.value = power.value.FlushDenormalToZero();
-          }
-          return Expr<T>{Constant<T>{power.value}};
+        using Exponent = ResultType<decltype(y)>;
+        FoldOperands(context, x.left(), y);
+        RealFlags flags;
+        if (auto power{ApplyElementwise<T>(context, x.left(), y,
+                [&](const Scalar<T> &a, const Scalar<Exponent> &b) {
+                  return FlushDenormals(context,
+                      evaluate::IntPower(a, b).AccumulateFlags(flags));
+                })}) {
+          RealFlagWarnings(context, flags, "power with INTEGER exponent");
+          return std::move(*power);
         } else {
           return Expr<T>{std::move(x)};
         }
@@ -327,23 +689,23 @@ Expr<T> FoldOperation(FoldingContext &context, RealToIntPower<T> &&x) {
 
 template<typename T>
 Expr<T> FoldOperation(FoldingContext &context, Extremum<T> &&x) {
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    if constexpr (T::category == TypeCategory::Integer) {
-      if (folded->first.CompareSigned(folded->second) == x.ordering) {
-        return Expr<T>{Constant<T>{folded->first}};
-      }
-    } else if constexpr (T::category == TypeCategory::Real) {
-      if (folded->first.IsNotANumber() ||
-          (folded->first.Compare(folded->second) == Relation::Less) ==
-              (x.ordering == Ordering::Less)) {
-        return Expr<T>{Constant<T>{folded->first}};
-      }
-    } else {
-      if (x.ordering == Compare(folded->first, folded->second)) {
-        return Expr<T>{Constant<T>{folded->first}};
-      }
-    }
-    return Expr<T>{Constant<T>{folded->second}};
+  FoldOperands(context, x.left(), x.right());
+  Ordering ordering{x.ordering};
+  if (auto extremum{ApplyElementwise<T>(context, x.left(), x.right(),
+          [=](const Scalar<T> &a, const Scalar<T> &b) {
+            if constexpr (T::category == TypeCategory::Integer) {
+              return a.CompareSigned(b) == ordering ? a : b;
+            } else if constexpr (T::category == TypeCategory::Real) {
+              return a.IsNotANumber() ||
+                      (a.Compare(b) == Relation::Less) ==
+                          (ordering == Ordering::Less)
+                  ? a
+                  : b;
+            } else {
+              return ordering == Compare(a, b) ? a : b;
+            }
+          })}) {
+    return std::move(*extremum);
   }
   return Expr<T>{std::move(x)};
 }
@@ -352,9 +714,13 @@ template<int KIND>
 Expr<Type<TypeCategory::Complex, KIND>> FoldOperation(
     FoldingContext &context, ComplexConstructor<KIND> &&x) {
   using Result = Type<TypeCategory::Complex, KIND>;
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    return Expr<Result>{
-        Constant<Result>{Scalar<Result>{folded->first, folded->second}}};
+  using Part = Type<TypeCategory::Real, KIND>;
+  FoldOperands(context, x.left(), x.right());
+  if (auto z{ApplyElementwise<Result>(context, x.left(), x.right(),
+          [](const Scalar<Part> &re, const Scalar<Part> &im) {
+            return Scalar<Result>{re, im};
+          })}) {
+    return std::move(*z);
   }
   return Expr<Result>{std::move(x)};
 }
@@ -363,8 +729,12 @@ template<int KIND>
 Expr<Type<TypeCategory::Character, KIND>> FoldOperation(
     FoldingContext &context, Concat<KIND> &&x) {
   using Result = Type<TypeCategory::Character, KIND>;
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    return Expr<Result>{Constant<Result>{folded->first + folded->second}};
+  FoldOperands(context, x.left(), x.right());
+  if (auto concatenated{ApplyElementwise<Result>(context, x.left(), x.right(),
+          [](const Scalar<Result> &a, const Scalar<Result> &b) {
+            return a + b;
+          })}) {
+    return std::move(*concatenated);
   }
   return Expr<Result>{std::move(x)};
 }
@@ -372,20 +742,23 @@ Expr<Type<TypeCategory::Character, KIND>> FoldOperation(
 template<typename T>
 Expr<LogicalResult> FoldOperation(
     FoldingContext &context, Relational<T> &&relation) {
-  if (auto folded{FoldOperands(context, relation.left(), relation.right())}) {
-    bool result{};
-    if constexpr (T::category == TypeCategory::Integer) {
-      result =
-          Satisfies(relation.opr, folded->first.CompareSigned(folded->second));
-    } else if constexpr (T::category == TypeCategory::Real) {
-      result = Satisfies(relation.opr, folded->first.Compare(folded->second));
-    } else if constexpr (T::category == TypeCategory::Character) {
-      result = Satisfies(relation.opr, Compare(folded->first, folded->second));
-    } else {
-      static_assert(T::category != TypeCategory::Complex &&
-          T::category != TypeCategory::Logical);
-    }
-    return Expr<LogicalResult>{Constant<LogicalResult>{result}};
+  FoldOperands(context, relation.left(), relation.right());
+  RelationalOperator opr{relation.opr};
+  if (auto result{ApplyElementwise<LogicalResult>(context, relation.left(),
+          relation.right(), [=](const Scalar<T> &a, const Scalar<T> &b) {
+            if constexpr (T::category == TypeCategory::Integer) {
+              return Scalar<LogicalResult>{
+                  Satisfies(opr, a.CompareSigned(b))};
+            } else if constexpr (T::category == TypeCategory::Real) {
+              return Scalar<LogicalResult>{Satisfies(opr, a.Compare(b))};
+            } else if constexpr (T::category == TypeCategory::Character) {
+              return Scalar<LogicalResult>{Satisfies(opr, Compare(a, b))};
+            } else {
+              static_assert(T::category != TypeCategory::Complex &&
+                  T::category != TypeCategory::Logical);
+            }
+          })}) {
+    return std::move(*result);
   }
   return Expr<LogicalResult>{Relational<SomeType>{std::move(relation)}};
 }
@@ -404,19 +777,334 @@ template<int KIND>
 Expr<Type<TypeCategory::Logical, KIND>> FoldOperation(
     FoldingContext &context, LogicalOperation<KIND> &&x) {
   using LOGICAL = Type<TypeCategory::Logical, KIND>;
-  if (auto folded{FoldOperands(context, x.left(), x.right())}) {
-    bool xt{folded->first.IsTrue()}, yt{folded->second.IsTrue()}, result{};
-    switch (x.logicalOperator) {
-    case LogicalOperator::And: result = xt && yt; break;
-    case LogicalOperator::Or: result = xt || yt; break;
-    case LogicalOperator::Eqv: result = xt == yt; break;
-    case LogicalOperator::Neqv: result = xt != yt; break;
-    }
-    return Expr<LOGICAL>{Constant<LOGICAL>{result}};
+  FoldOperands(context, x.left(), x.right());
+  LogicalOperator logicalOperator{x.logicalOperator};
+  if (auto result{ApplyElementwise<LOGICAL>(context, x.left(), x.right(),
+          [=](const Scalar<LOGICAL> &a, const Scalar<LOGICAL> &b) {
+            bool xt{a.IsTrue()}, yt{b.IsTrue()}, result{};
+            switch (logicalOperator) {
+            case LogicalOperator::And: result = xt && yt; break;
+            case LogicalOperator::Or: result = xt || yt; break;
+            case LogicalOperator::Eqv: result = xt == yt; break;
+            case LogicalOperator::Neqv: result = xt != yt; break;
+            }
+            return Scalar<LOGICAL>{result};
+          })}) {
+    return std::move(*result);
   }
   return Expr<LOGICAL>{std::move(x)};
 }
 
+// Intrinsic function references
+// References to intrinsic functions are folded by table-driven folders that
+// are indexed by the generic name of the SpecificIntrinsic to which
+// IntrinsicProcTable::Probe() resolved the reference.  The actual arguments
+// appear in dummy argument order, with absent optional arguments empty.
+// A folder returns std::nullopt when it cannot fold a reference, which then
+// remains in the expression with its arguments folded.
+
+template<typename T> struct IntrinsicFolder {
+  const char *name;  // generic intrinsic name; tables are sorted on it
+  std::optional<Expr<T>> (*fold)(FoldingContext &, ActualArguments &);
+};
+
+template<typename T>
+Expr<T> *UnwrapArgument(std::optional<ActualArgument> &arg) {
+  if (arg.has_value()) {
+    if (auto *catExpr{
+            std::get_if<Expr<SomeKind<T::category>>>(&arg->value->u)}) {
+      return std::get_if<Expr<T>>(&catExpr->u);
+    }
+  }
+  return nullptr;
+}
+
+// Converts an INTEGER argument of any kind, or a BOZ literal, to type T.
+template<typename T>
+std::optional<Expr<T>> ConvertIntegerArgument(
+    FoldingContext &context, const std::optional<ActualArgument> &arg) {
+  if (arg.has_value()) {
+    if (const auto *intExpr{std::get_if<Expr<SomeInteger>>(&arg->value->u)}) {
+      return Fold(context, ConvertToType<T>(Expr<SomeInteger>{*intExpr}));
+    } else if (const auto *boz{
+                   std::get_if<BOZLiteralConstant>(&arg->value->u)}) {
+      return ConvertToType<T>(BOZLiteralConstant{*boz});
+    }
+  }
+  return std::nullopt;
+}
+
+inline const ConstantSubscripts *GetConstantShape(const BOZLiteralConstant &) {
+  return nullptr;
+}
+template<typename T>
+const ConstantSubscripts *GetConstantShape(const Expr<T> &expr) {
+  if constexpr (T::isSpecificIntrinsicType) {
+    if (const Constant<T> *c{UnwrapConstant(expr)}) {
+      return &c->shape;
+    }
+    return nullptr;
+  } else if constexpr (std::is_same_v<T, SomeDerived>) {
+    return nullptr;
+  } else {
+    return std::visit(
+        [](const auto &x) { return GetConstantShape(x); }, expr.u);
+  }
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldABS(FoldingContext &context, ActualArguments &args) {
+  if (const Expr<T> *x{UnwrapArgument<T>(args[0])}) {
+    if constexpr (T::category == TypeCategory::Integer) {
+      bool overflow{false};
+      auto result{ApplyElementwise<T>(*x, [&](const Scalar<T> &a) {
+        auto abs{a.ABS()};
+        overflow |= abs.overflow;
+        return abs.value;
+      })};
+      if (overflow) {
+        context.messages.Say("INTEGER(%d) ABS overflowed"_en_US, T::kind);
+      }
+      return result;
+    } else {
+      return ApplyElementwise<T>(
+          *x, [](const Scalar<T> &a) { return a.ABS(); });
+    }
+  }
+  return std::nullopt;
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldExtremum(
+    FoldingContext &context, ActualArguments &args, Ordering ordering) {
+  std::optional<Expr<T>> result;
+  for (auto &arg : args) {
+    if (arg.has_value()) {
+      const Expr<T> *x{UnwrapArgument<T>(arg)};
+      if (x == nullptr || UnwrapConstant(*x) == nullptr) {
+        return std::nullopt;  // e.g., AMAX0
+      }
+      if (result.has_value()) {
+        result = Fold(context,
+            Expr<T>{Extremum<T>{std::move(*result), Expr<T>{*x}, ordering}});
+      } else {
+        result = *x;
+      }
+    }
+  }
+  if (result.has_value() && UnwrapConstant(*result) != nullptr) {
+    return result;
+  }
+  return std::nullopt;
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldHUGE(FoldingContext &, ActualArguments &) {
+  return Expr<T>{Constant<T>{Scalar<T>::HUGE()}};
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldIAND(
+    FoldingContext &context, ActualArguments &args) {
+  if (auto i{ConvertIntegerArgument<T>(context, args[0])}) {
+    if (auto j{ConvertIntegerArgument<T>(context, args[1])}) {
+      return ApplyElementwise<T>(context, *i, *j,
+          [](const Scalar<T> &a, const Scalar<T> &b) { return a.IAND(b); });
+    }
+  }
+  return std::nullopt;
+}
+
+// SHIFT= may be of any kind, so its range is checked in the widest one;
+// converting it to the kind of I= first could wrap it into range.
+template<typename T>
+std::optional<Expr<T>> FoldISHFT(
+    FoldingContext &context, ActualArguments &args) {
+  using Shift = Type<TypeCategory::Integer, 16>;
+  if (const Expr<T> *i{UnwrapArgument<T>(args[0])}) {
+    if (auto shift{ConvertIntegerArgument<Shift>(context, args[1])}) {
+      const Scalar<Shift> low{-Scalar<T>::bits}, high{Scalar<T>::bits};
+      bool outOfRange{false};
+      auto result{ApplyElementwise<T>(context, *i, *shift,
+          [&](const Scalar<T> &a, const Scalar<Shift> &s) {
+            if (s.CompareSigned(low) == Ordering::Less ||
+                s.CompareSigned(high) == Ordering::Greater) {
+              outOfRange = true;
+              return a;
+            }
+            return a.ISHFT(static_cast<int>(s.ToInt64()));
+          })};
+      if (!outOfRange) {
+        return result;
+      }
+      context.messages.Say(
+          "SHIFT= argument of ISHFT is out of range for INTEGER(%d)"_err_en_US,
+          T::kind);
+    }
+  }
+  return std::nullopt;
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldKIND(FoldingContext &, ActualArguments &args) {
+  if (args[0].has_value()) {
+    if (auto type{args[0]->GetType()}) {
+      return Expr<T>{Constant<T>{Scalar<T>{type->kind}}};
+    }
+  }
+  return std::nullopt;
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldLEN(FoldingContext &context, ActualArguments &args) {
+  if (args[0].has_value()) {
+    if (const auto *charExpr{
+            std::get_if<Expr<SomeCharacter>>(&args[0]->value->u)}) {
+      Expr<SubscriptInteger> len{std::visit(
+          [](const auto &kindExpr) { return kindExpr.LEN(); }, charExpr->u)};
+      if (auto value{ToInt64(Fold(context, std::move(len)))}) {
+        return Expr<T>{Constant<T>{Scalar<T>{*value}}};
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldMAX(FoldingContext &context, ActualArguments &args) {
+  return FoldExtremum<T>(context, args, Ordering::Greater);
+}
+
+template<typename T>
+std::optional<Expr<T>> FoldMIN(FoldingContext &context, ActualArguments &args) {
+  return FoldExtremum<T>(context, args, Ordering::Less);
+}
+
+// The kind of the INTEGER type with the least decimal exponent range
+// that is at least R, or -1.
+template<typename T>
+std::optional<Expr<T>> FoldSELECTED_INT_KIND(
+    FoldingContext &, ActualArguments &args) {
+  static constexpr struct {
+    int kind, range;
+  } integerKinds[]{
+      {1, Scalar<Type<TypeCategory::Integer, 1>>::RANGE()},
+      {2, Scalar<Type<TypeCategory::Integer, 2>>::RANGE()},
+      {4, Scalar<Type<TypeCategory::Integer, 4>>::RANGE()},
+      {8, Scalar<Type<TypeCategory::Integer, 8>>::RANGE()},
+      {16, Scalar<Type<TypeCategory::Integer, 16>>::RANGE()},
+  };
+  if (args[0].has_value()) {
+    if (auto r{ToInt64(*args[0]->value)}) {
+      int kind{-1};
+      for (const auto &k : integerKinds) {
+        if (k.range >= *r) {
+          kind = k.kind;
+          break;
+        }
+      }
+      return Expr<T>{Constant<T>{Scalar<T>{kind}}};
+    }
+  }
+  return std::nullopt;
+}
+
+// SIZE(ARRAY [, DIM] [, KIND]) of a constant array
+template<typename T>
+std::optional<Expr<T>> FoldSIZE(
+    FoldingContext &context, ActualArguments &args) {
+  if (args[0].has_value()) {
+    if (const ConstantSubscripts *shape{GetConstantShape(*args[0]->value)}) {
+      int rank = shape->size();
+      if (rank == 0) {
+        return std::nullopt;
+      }
+      std::int64_t size;
+      if (args.size() == 3 && args[1].has_value()) {  // DIM= is present
+        auto dim{ToInt64(*args[1]->value)};
+        if (!dim.has_value()) {
+          return std::nullopt;
+        }
+        if (*dim < 1 || *dim > rank) {
+          context.messages.Say(
+              "DIM=%jd is not valid for an array of rank %d"_err_en_US,
+              static_cast<std::intmax_t>(*dim), rank);
+          return std::nullopt;
+        }
+        size = (*shape)[*dim - 1];
+      } else {
+        size = TotalElementCount(*shape);
+      }
+      return Expr<T>{Constant<T>{Scalar<T>{size}}};
+    }
+  }
+  return std::nullopt;
+}
+
+template<typename T, std::size_t N>
+const IntrinsicFolder<T> *FindIntrinsicFolder(
+    const IntrinsicFolder<T> (&table)[N], const char *name) {
+  const IntrinsicFolder<T> *iter{std::lower_bound(table, table + N, name,
+      [](const IntrinsicFolder<T> &folder, const char *n) {
+        return std::strcmp(folder.name, n) < 0;
+      })};
+  if (iter < table + N && std::strcmp(iter->name, name) == 0) {
+    return iter;
+  }
+  return nullptr;
+}
+
+template<typename T>
+const IntrinsicFolder<T> *FindIntrinsicFolder(const char *name) {
+  if constexpr (T::category == TypeCategory::Integer) {
+    static constexpr IntrinsicFolder<T> table[]{
+        {"abs", FoldABS<T>},
+        {"huge", FoldHUGE<T>},
+        {"iand", FoldIAND<T>},
+        {"ishft", FoldISHFT<T>},
+        {"kind", FoldKIND<T>},
+        {"len", FoldLEN<T>},
+        {"max", FoldMAX<T>},
+        {"min", FoldMIN<T>},
+        {"selected_int_kind", FoldSELECTED_INT_KIND<T>},
+        {"size", FoldSIZE<T>},
+    };
+    return FindIntrinsicFolder(table, name);
+  } else if constexpr (T::category == TypeCategory::Real) {
+    static constexpr IntrinsicFolder<T> table[]{
+        {"abs", FoldABS<T>},
+        {"huge", FoldHUGE<T>},
+        {"max", FoldMAX<T>},
+        {"min", FoldMIN<T>},
+    };
+    return FindIntrinsicFolder(table, name);
+  } else {
+    return nullptr;
+  }
+}
+
+template<typename T>
+Expr<T> FoldOperation(FoldingContext &context, FunctionRef<T> &&funcRef) {
+  if constexpr (T::isSpecificIntrinsicType) {
+    if (const auto *intrinsic{
+            std::get_if<SpecificIntrinsic>(&funcRef.proc().u)}) {
+      if (const IntrinsicFolder<T> *folder{
+              FindIntrinsicFolder<T>(intrinsic->name)}) {
+        ActualArguments &args{funcRef.arguments()};
+        for (std::optional<ActualArgument> &arg : args) {
+          if (arg.has_value()) {
+            *arg->value = Fold(context, std::move(*arg->value));
+          }
+        }
+        if (std::optional<Expr<T>> folded{folder->fold(context, args)}) {
+          return std::move(*folded);
+        }
+      }
+    }
+  }
+  return Expr<T>{std::move(funcRef)};
+}
+
 // end per-operation folding functions
 
 template<typename T>
@@ -443,7 +1131,11 @@ template<typename T>
 std::optional<Constant<T>>
 GetScalarConstantValueHelper<T>::GetScalarConstantValue(const Expr<T> &expr) {
   if (const auto *c{std::get_if<Constant<T>>(&expr.u)}) {
-    return {*c};
+    if (c->Rank() == 0) {
+      return {*c};
+    } else {
+      return std::nullopt;
+    }
   } else if (const auto *p{std::get_if<Parentheses<T>>(&expr.u)}) {
     return GetScalarConstantValue(p->left());
   } else {
@@ -452,4 +1144,43 @@ GetScalarConstantValueHelper<T>::GetScalarConstantValue(const Expr<T> &expr) {
 }
 
 FOR_EACH_INTRINSIC_KIND(template struct GetScalarConstantValueHelper)
+
+void FoldCache::Validate(const FoldingContext &context) {
+  if (context.rounding != rounding_ ||
+      context.flushDenormalsToZero != flushDenormalsToZero_) {
+    if (!folded_.empty()) {
+      folded_.clear();
+      ++invalidations_;
+    }
+    rounding_ = context.rounding;
+    flushDenormalsToZero_ = context.flushDenormalsToZero;
+  }
+}
+
+const Expr<SomeType> *FoldCache::Find(
+    const FoldingContext &context, const void *key) {
+  Validate(context);
+  ++lookups_;
+  auto iter{folded_.find(key)};
+  if (iter == folded_.end()) {
+    return nullptr;
+  }
+  ++hits_;
+  return &iter->second;
+}
+
+const Expr<SomeType> &FoldCache::Insert(
+    const FoldingContext &context, const void *key, Expr<SomeType> &&expr) {
+  Validate(context);
+  return folded_.insert_or_assign(key, std::move(expr)).first->second;
+}
+
+std::ostream &FoldCache::Dump(std::ostream &o) const {
+  o << "fold cache: " << lookups_ << " lookups, " << hits_ << " hits";
+  if (lookups_ > 0) {
+    o << " (" << (100 * hits_ + lookups_ / 2) / lookups_ << "%)";
+  }
+  return o << ", " << invalidations_ << " invalidations, " << folded_.size()
+           << " entries\n";
+}
 }
@@ -21,6 +21,9 @@
 #include "common.h"
 #include "expression.h"
 #include "type.h"
+#include <cstddef>
+#include <iosfwd>
+#include <unordered_map>
 
 namespace Fortran::evaluate {
 
@@ -44,6 +47,32 @@ std::optional<Expr<T>> Fold(
   }
 }
 
+// A FoldCache remembers the folded forms of expressions so that an
+// expression that is analyzed and folded more than once -- e.g., an array
+// bound shared by all of the entities in a declaration -- is folded only
+// once.  Entries are keyed by the identity of their source, typically a
+// parse tree node, and are discarded whenever the rounding mode or denormal
+// flushing of the FoldingContext changes, since folded results may depend
+// on them.  Attach a cache to a FoldingContext to enable its use, and
+// Clear() it before the sources of its keys are destroyed.
+class FoldCache {
+public:
+  const Expr<SomeType> *Find(const FoldingContext &, const void *key);
+  const Expr<SomeType> &Insert(
+      const FoldingContext &, const void *key, Expr<SomeType> &&);
+  std::size_t size() const { return folded_.size(); }
+  void Clear() { folded_.clear(); }
+  std::ostream &Dump(std::ostream &) const;  // usage statistics
+
+private:
+  void Validate(const FoldingContext &);
+
+  std::unordered_map<const void *, Expr<SomeType>> folded_;
+  Rounding rounding_{defaultRounding};
+  bool flushDenormalsToZero_{false};
+  std::size_t lookups_{0}, hits_{0}, invalidations_{0};
+};
+
 // GetScalarConstantValue() extracts the constant value of an expression,
 // when it has one, even if it is parenthesized or optional.
 template<typename T> struct GetScalarConstantValueHelper {
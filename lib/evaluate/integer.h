@@ -86,6 +86,20 @@ private:
   static constexpr Part partMask{static_cast<Part>(~0) >> extraPartBits};
   static constexpr Part topPartMask{static_cast<Part>(~0) >> extraTopPartBits};
 
+  // Instances with the default configuration whose values fit in a host
+  // std::uint64_t perform some arithmetic with native host operations
+  // instead of part by part.  Other configurations, such as those used
+  // for exhaustive testing, retain the part-by-part algorithms.
+  static constexpr bool hostArithmetic{bits <= 64 &&
+      littleEndian == IsHostLittleEndian &&
+      partBits == (bits <= 32 ? bits : 32) &&
+      std::is_same_v<Part, HostUnsignedInt<partBits>>};
+#ifdef __SIZEOF_INT128__
+  static constexpr bool hostProduct{hostArithmetic};
+#else
+  static constexpr bool hostProduct{hostArithmetic && bits <= 32};
+#endif
+
 public:
   // Some types used for member function results
   struct ValueWithOverflow {
@@ -723,6 +737,15 @@ public:
   // Unsigned addition with carry.
   constexpr ValueWithCarry AddUnsigned(
       const Integer &y, bool carryIn = false) const {
+    if constexpr (hostArithmetic) {
+      std::uint64_t x{ToUInt64()};
+      std::uint64_t sum{x + y.ToUInt64() + carryIn};
+      if constexpr (bits < 64) {
+        return {Integer{sum}, (sum >> bits) != 0};
+      } else {
+        return {Integer{sum}, sum < x || (carryIn && sum == x)};
+      }
+    }
     Integer sum{nullptr};
     BigPart carry{carryIn};
     for (int j{0}; j + 1 < parts; ++j) {
@@ -774,6 +797,19 @@ public:
   }
 
   constexpr Product MultiplyUnsigned(const Integer &y) const {
+    if constexpr (hostProduct) {
+      if constexpr (bits <= 32) {
+        std::uint64_t product{ToUInt64() * y.ToUInt64()};
+        return {Integer{product >> bits}, Integer{product}};
+      } else {
+#ifdef __SIZEOF_INT128__
+        __uint128_t product{ToUInt64()};
+        product *= y.ToUInt64();
+        return {Integer{static_cast<std::uint64_t>(product >> bits)},
+            Integer{static_cast<std::uint64_t>(product)}};
+#endif
+      }
+    }
     Part product[2 * parts]{};  // little-endian full product
     for (int j{0}; j < parts; ++j) {
       if (Part xpart{LEPart(j)}) {
@@ -804,6 +840,19 @@ public:
   }
 
   constexpr Product MultiplySigned(const Integer &y) const {
+    if constexpr (hostProduct) {
+      if constexpr (bits <= 32) {
+        std::int64_t product{ToInt64() * y.ToInt64()};
+        return {Integer{product >> bits}, Integer{product}};
+      } else {
+#ifdef __SIZEOF_INT128__
+        __int128_t product{ToInt64()};
+        product *= y.ToInt64();
+        return {Integer{static_cast<std::uint64_t>(product >> bits)},
+            Integer{static_cast<std::uint64_t>(product)}};
+#endif
+      }
+    }
     bool yIsNegative{y.IsNegative()};
     Integer absy{y};
     if (yIsNegative) {
@@ -832,6 +881,11 @@ public:
     if (divisor.IsZero()) {
       return {MASKR(bits), Integer{}, true, false};  // overflow to max value
     }
+    if constexpr (hostArithmetic) {
+      std::uint64_t dividend{ToUInt64()}, divisorValue{divisor.ToUInt64()};
+      return {Integer{dividend / divisorValue}, Integer{dividend % divisorValue},
+          false, false};
+    }
     int bitsDone{LEADZ()};
     Integer top{SHIFTL(bitsDone)};
     Integer quotient, remainder;
@@ -21,10 +21,11 @@
 #include "../common/idioms.h"
 #include "../semantics/default-kinds.h"
 #include <algorithm>
-#include <map>
+#include <cstdint>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 using namespace Fortran::parser::literals;
@@ -110,6 +111,7 @@ static constexpr TypePattern AnyNumeric{NumericType, KindCode::any};
 static constexpr TypePattern AnyChar{CharType, KindCode::any};
 static constexpr TypePattern AnyLogical{LogicalType, KindCode::any};
 static constexpr TypePattern AnyRelatable{RelatableType, KindCode::any};
+static constexpr TypePattern AnyIntrinsic{IntrinsicType, KindCode::any};
 static constexpr TypePattern Anything{AnyType, KindCode::any};
 
 // Match some kind of some intrinsic type(s); all "Same" values must match,
@@ -218,7 +220,7 @@ struct IntrinsicInterface {
 // standard, but rarely appear in actual code), a type and kind
 // pattern, allowable ranks, and optionality indicators.
 // Be advised, the default rank pattern is "elemental".
-static const IntrinsicInterface genericIntrinsicFunction[]{
+static constexpr IntrinsicInterface genericIntrinsicFunction[]{
     {"abs", {{"a", SameIntOrReal}}, SameIntOrReal},
     {"abs", {{"a", SameComplex}}, SameReal},
     {"achar", {{"i", AnyInt}, DefaultingKIND}, KINDChar},
@@ -349,6 +351,8 @@ static const IntrinsicInterface genericIntrinsicFunction[]{
     {"floor", {{"a", AnyReal}, DefaultingKIND}, KINDInt},
     {"fraction", {{"x", SameReal}}, SameReal},
     {"gamma", {{"x", SameReal}}, SameReal},
+    {"huge", {{"x", SameIntOrReal, Rank::anyOrAssumedRank}}, SameIntOrReal,
+        Rank::scalar},
     {"hypot", {{"x", SameReal}, {"y", SameReal}}, SameReal},
     {"iachar", {{"c", AnyChar}, DefaultingKIND}, KINDInt},
     {"iall", {{"array", SameInt, Rank::array}, OptionalDIM, OptionalMASK},
@@ -384,6 +388,8 @@ static const IntrinsicInterface genericIntrinsicFunction[]{
         SameInt},
     {"is_iostat_end", {{"i", AnyInt}}, DefaultLogical},
     {"is_iostat_eor", {{"i", AnyInt}}, DefaultLogical},
+    {"kind", {{"x", AnyIntrinsic, Rank::anyOrAssumedRank}}, DefaultInt,
+        Rank::scalar},
     {"lbound",
         {{"array", Anything, Rank::anyOrAssumedRank}, SubscriptDefaultKIND},
         KINDInt, Rank::vector},
@@ -544,7 +550,7 @@ static const IntrinsicInterface genericIntrinsicFunction[]{
     {"sinh", {{"x", SameFloating}}, SameFloating},
     {"size",
         {{"array", Anything, Rank::anyOrAssumedRank}, SubscriptDefaultKIND},
-        KINDInt, Rank::vector},
+        KINDInt, Rank::scalar},
     {"size",
         {{"array", Anything, Rank::anyOrAssumedRank},
             {"dim", {IntType, KindCode::dimArg}, Rank::scalar},
@@ -601,7 +607,7 @@ static const IntrinsicInterface genericIntrinsicFunction[]{
 //   ALLOCATED, ASSOCIATED, EXTENDS_TYPE_OF, IS_CONTIGUOUS,
 //   PRESENT, RANK, SAME_TYPE, STORAGE_SIZE
 // TODO: Type inquiry intrinsic functions - these return constants
-//  BIT_SIZE, DIGITS, EPSILON, HUGE, KIND, MAXEXPONENT, MINEXPONENT,
+//  BIT_SIZE, DIGITS, EPSILON, MAXEXPONENT, MINEXPONENT,
 //  NEW_LINE, PRECISION, RADIX, RANGE, TINY
 // TODO: Non-standard intrinsic functions
 //  AND, OR, XOR, LSHIFT, RSHIFT, SHIFT, ZEXT, IZEXT,
@@ -620,7 +626,7 @@ struct SpecificIntrinsicInterface : public IntrinsicInterface {
       false};  // when true, can only be called, not passed
 };
 
-static const SpecificIntrinsicInterface specificIntrinsicFunction[]{
+static constexpr SpecificIntrinsicInterface specificIntrinsicFunction[]{
     {{"abs", {{"a", DefaultReal}}, DefaultReal}},
     {{"acos", {{"x", DefaultReal}}, DefaultReal}},
     {{"aimag", {{"z", DefaultComplex}}, DefaultReal}},
@@ -1161,29 +1167,253 @@ std::optional<SpecificCall> IntrinsicInterface::Match(
       std::move(rearranged)}};
 }
 
-struct IntrinsicProcTable::Implementation {
-  explicit Implementation(const semantics::IntrinsicTypeDefaultKinds &dfts)
-    : defaults{dfts} {
-    for (const IntrinsicInterface &f : genericIntrinsicFunction) {
-      genericFuncs.insert(std::make_pair(std::string{f.name}, &f));
+// The interfaces in the tables above are located by name with perfect
+// hash functions that are constructed at compilation time.  All of the
+// interfaces for a name must be adjacent in their table.  Each name hashes
+// to a bucket whose displacement seeds a second hash that maps the name to
+// a slot of its own; that slot records the name's range of table entries.
+static constexpr std::uint32_t HashName(
+    const char *name, std::size_t length, std::uint32_t seed) {
+  std::uint32_t hash{2166136261u ^ seed};  // FNV-1a
+  for (std::size_t j{0}; j < length; ++j) {
+    hash = (hash ^ static_cast<unsigned char>(name[j])) * 16777619u;
+  }
+  hash ^= hash >> 16;  // final avalanche, as in MurmurHash3
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  return hash ^ (hash >> 16);
+}
+
+static constexpr std::size_t NameLength(const char *name) {
+  std::size_t length{0};
+  while (name[length] != '\0') {
+    ++length;
+  }
+  return length;
+}
+
+static constexpr bool SameName(const char *x, const char *y) {
+  for (; *x == *y; ++x, ++y) {
+    if (*x == '\0') {
+      return true;
     }
-    for (const SpecificIntrinsicInterface &f : specificIntrinsicFunction) {
-      specificFuncs.insert(std::make_pair(std::string{f.name}, &f));
+  }
+  return false;
+}
+
+template<typename INTERFACE, std::size_t ENTRIES> class IntrinsicNameTable {
+  static_assert(ENTRIES < 0x10000);
+  static constexpr std::size_t buckets{ENTRIES / 2 + 1};
+  static constexpr std::size_t slots{[] {
+    std::size_t n{1};
+    while (n < 2 * ENTRIES) {
+      n *= 2;
+    }
+    return n;
+  }()};
+
+public:
+  constexpr explicit IntrinsicNameTable(const INTERFACE (&table)[ENTRIES])
+    : table_{table} {
+    // Find the first entry for each distinct name and its bucket.
+    std::uint16_t first[ENTRIES]{}, bucket[ENTRIES]{};
+    std::size_t bucketSize[buckets]{};
+    std::size_t names{0}, maxBucketSize{0};
+    for (std::size_t j{0}; j < ENTRIES; ++j) {
+      if (j == 0 || !SameName(table[j - 1].name, table[j].name)) {
+        const char *name{table[j].name};
+        std::size_t b{HashName(name, NameLength(name), 0) % buckets};
+        first[names] = j;
+        bucket[names++] = b;
+        maxBucketSize = std::max(maxBucketSize, ++bucketSize[b]);
+      }
+    }
+    // Assign slots to the names of the fullest buckets first.
+    for (std::size_t size{maxBucketSize}; size > 0; --size) {
+      for (std::size_t b{0}; b < buckets; ++b) {
+        if (bucketSize[b] == size) {
+          Place(first, bucket, names, b);
+        }
+      }
     }
   }
 
+  // Returns the interfaces with a given name as a [begin, end) range.
+  std::pair<const INTERFACE *, const INTERFACE *> Find(
+      const parser::CharBlock &name) const {
+    std::size_t b{HashName(name.begin(), name.size(), 0) % buckets};
+    std::size_t slot{
+        HashName(name.begin(), name.size(), displacement_[b]) & (slots - 1)};
+    const INTERFACE *begin{table_ + first_[slot]};
+    if (count_[slot] == 0 || name != begin->name) {
+      return {nullptr, nullptr};
+    }
+    return {begin, begin + count_[slot]};
+  }
+
+private:
+  // Finds a displacement for a bucket that maps each of its names to a
+  // distinct free slot.
+  constexpr void Place(const std::uint16_t (&first)[ENTRIES],
+      const std::uint16_t (&bucket)[ENTRIES], std::size_t names,
+      std::size_t b) {
+    for (std::uint32_t d{1}; d < 0x10000; ++d) {
+      bool fits{true};
+      for (std::size_t j{0}; fits && j < names; ++j) {
+        if (bucket[j] == b) {
+          const char *name{table_[first[j]].name};
+          std::size_t slot{HashName(name, NameLength(name), d) & (slots - 1)};
+          if (count_[slot] != 0) {
+            CHECK(!SameName(name, table_[first_[slot]].name) ||
+                !"intrinsic interfaces with the same name must be adjacent");
+            fits = false;
+          } else {
+            first_[slot] = first[j];
+            count_[slot] = (j + 1 < names ? first[j + 1] : ENTRIES) - first[j];
+          }
+        }
+      }
+      if (fits) {
+        displacement_[b] = d;
+        return;
+      }
+      for (std::size_t j{0}; j < names; ++j) {  // back out a failed attempt
+        if (bucket[j] == b) {
+          const char *name{table_[first[j]].name};
+          std::size_t slot{HashName(name, NameLength(name), d) & (slots - 1)};
+          if (first_[slot] == first[j]) {
+            count_[slot] = 0;
+          }
+        }
+      }
+    }
+    CHECK(!"no perfect hash for intrinsic names");
+  }
+
+  const INTERFACE *table_;
+  std::uint16_t displacement_[buckets]{};
+  std::uint16_t first_[slots]{}, count_[slots]{};
+};
+
+static constexpr IntrinsicNameTable genericFuncs{genericIntrinsicFunction};
+static constexpr IntrinsicNameTable specificFuncs{specificIntrinsicFunction};
+
+struct IntrinsicProcTable::Implementation {
+  explicit Implementation(const semantics::IntrinsicTypeDefaultKinds &dfts)
+    : defaults{dfts} {}
+
   std::optional<SpecificCall> Probe(const CallCharacteristics &,
       ActualArguments &, parser::ContextualMessages *) const;
+  std::optional<SpecificCall> ProbeTables(const CallCharacteristics &,
+      ActualArguments &, parser::ContextualMessages *) const;
 
   semantics::IntrinsicTypeDefaultKinds defaults;
-  std::multimap<std::string, const IntrinsicInterface *> genericFuncs;
-  std::multimap<std::string, const SpecificIntrinsicInterface *> specificFuncs;
   std::ostream &Dump(std::ostream &) const;
+
+  // Successful probes are memoized by the signatures of their calls: the
+  // name, and the keyword, type, and rank of each actual argument.  When
+  // the intrinsic has a KIND= argument, the signature also includes the
+  // values of INTEGER scalar constant arguments, since they can determine
+  // the result type.  A repeated call is resolved with a single hash lookup.
+  struct ResolvedCall {
+    SpecificIntrinsic specificIntrinsic;
+    std::vector<int> actualForDummy;  // argument index, or -1 if absent
+  };
+  void GetSignature(const CallCharacteristics &, const ActualArguments &) const;
+  mutable std::string signature;  // reused to avoid reallocation
+  mutable std::unordered_map<std::string, ResolvedCall> resolvedCalls;
 };
 
+void IntrinsicProcTable::Implementation::GetSignature(
+    const CallCharacteristics &call, const ActualArguments &arguments) const {
+  auto put{[&](const auto &x) {
+    signature.append(reinterpret_cast<const char *>(&x), sizeof x);
+  }};
+  bool hasKindArg{false};
+  auto checkKindArg{[&](const auto &range) {
+    for (auto iter{range.first}; iter != range.second; ++iter) {
+      for (const IntrinsicDummyArgument &d : iter->dummy) {
+        hasKindArg |= d.typePattern.kindCode == KindCode::kindArg;
+      }
+    }
+  }};
+  checkKindArg(genericFuncs.Find(call.name));
+  checkKindArg(specificFuncs.Find(call.name));
+  signature.assign(call.name.begin(), call.name.size());
+  put(call.isSubroutineCall);
+  for (const std::optional<ActualArgument> &arg : arguments) {
+    put(arg.has_value());
+    if (arg.has_value()) {
+      put(arg->isAlternateReturn);
+      put(arg->keyword.has_value());
+      if (arg->keyword.has_value()) {
+        put(arg->keyword->size());
+        signature.append(arg->keyword->begin(), arg->keyword->size());
+      }
+      std::optional<DynamicType> type{arg->GetType()};
+      put(type.has_value());
+      if (type.has_value()) {
+        put(type->category);
+        put(type->kind);
+        put(type->derived);
+      }
+      int rank{arg->Rank()};
+      put(rank);
+      put(IsAssumedRank(*arg->value));
+      if (hasKindArg && rank == 0 && type.has_value() &&
+          type->category == TypeCategory::Integer) {
+        std::optional<std::int64_t> value{ToInt64(*arg->value)};
+        put(value.has_value());
+        put(value.value_or(0));
+      } else if (rank == 1) {
+        put(arg->VectorSize().value_or(-1));
+      }
+    }
+  }
+}
+
+std::optional<SpecificCall> IntrinsicProcTable::Implementation::Probe(
+    const CallCharacteristics &call, ActualArguments &arguments,
+    parser::ContextualMessages *messages) const {
+  GetSignature(call, arguments);
+  if (auto iter{resolvedCalls.find(signature)}; iter != resolvedCalls.end()) {
+    const ResolvedCall &resolved{iter->second};
+    ActualArguments rearranged(resolved.actualForDummy.size());
+    for (std::size_t j{0}; j < rearranged.size(); ++j) {
+      if (int k{resolved.actualForDummy[j]}; k >= 0) {
+        rearranged[j] = std::move(arguments[k]);
+      }
+    }
+    return {SpecificCall{
+        SpecificIntrinsic{resolved.specificIntrinsic}, std::move(rearranged)}};
+  }
+  // Matching moves the actual arguments into dummy argument order, but
+  // each one's expression stays in place, which identifies it afterwards.
+  std::vector<const Expr<SomeType> *> actualExprs;
+  for (const std::optional<ActualArgument> &arg : arguments) {
+    actualExprs.push_back(arg.has_value() ? &*arg->value : nullptr);
+  }
+  std::optional<SpecificCall> specificCall{
+      ProbeTables(call, arguments, messages)};
+  if (specificCall.has_value()) {
+    ResolvedCall resolved{specificCall->specificIntrinsic, {}};
+    for (const std::optional<ActualArgument> &arg : specificCall->arguments) {
+      auto iter{arg.has_value()
+              ? std::find(actualExprs.begin(), actualExprs.end(), &*arg->value)
+              : actualExprs.end()};
+      resolved.actualForDummy.push_back(iter == actualExprs.end()
+              ? -1
+              : static_cast<int>(iter - actualExprs.begin()));
+    }
+    resolvedCalls.emplace(signature, std::move(resolved));
+  }
+  return specificCall;
+}
+
 // Probe the configured intrinsic procedure pattern tables in search of a
 // match for a given procedure reference.
-std::optional<SpecificCall> IntrinsicProcTable::Implementation::Probe(
+std::optional<SpecificCall> IntrinsicProcTable::Implementation::ProbeTables(
     const CallCharacteristics &call, ActualArguments &arguments,
     parser::ContextualMessages *messages) const {
   if (call.isSubroutineCall) {
@@ -1195,16 +1425,15 @@ std::optional<SpecificCall> IntrinsicProcTable::Implementation::Probe(
   parser::ContextualMessages specificErrors{
       messages ? messages->at() : call.name,
       finalBuffer ? &specificBuffer : nullptr};
-  std::string name{call.name.ToString()};
-  auto specificRange{specificFuncs.equal_range(name)};
+  auto specificRange{specificFuncs.Find(call.name)};
   for (auto iter{specificRange.first}; iter != specificRange.second; ++iter) {
     if (auto specificCall{
-            iter->second->Match(call, defaults, arguments, specificErrors)}) {
-      if (const char *genericName{iter->second->generic}) {
+            iter->Match(call, defaults, arguments, specificErrors)}) {
+      if (const char *genericName{iter->generic}) {
         specificCall->specificIntrinsic.name = genericName;
       }
       specificCall->specificIntrinsic.isRestrictedSpecific =
-          iter->second->isRestrictedSpecific;
+          iter->isRestrictedSpecific;
       return specificCall;
     }
   }
@@ -1213,15 +1442,15 @@ std::optional<SpecificCall> IntrinsicProcTable::Implementation::Probe(
   parser::ContextualMessages genericErrors{
       messages ? messages->at() : call.name,
       finalBuffer ? &genericBuffer : nullptr};
-  auto genericRange{genericFuncs.equal_range(name)};
+  auto genericRange{genericFuncs.Find(call.name)};
   for (auto iter{genericRange.first}; iter != genericRange.second; ++iter) {
     if (auto specificCall{
-            iter->second->Match(call, defaults, arguments, genericErrors)}) {
+            iter->Match(call, defaults, arguments, genericErrors)}) {
       return specificCall;
     }
   }
   // Special cases of intrinsic functions
-  if (call.name.ToString() == "null") {
+  if (call.name == "null") {
     if (arguments.size() == 0) {
       // TODO: NULL() result type is determined by context
       // Can pass that context in, or return a token distinguishing
@@ -1312,13 +1541,13 @@ std::ostream &IntrinsicInterface::Dump(std::ostream &o) const {
 
 std::ostream &IntrinsicProcTable::Implementation::Dump(std::ostream &o) const {
   o << "generic intrinsic functions:\n";
-  for (const auto &iter : genericFuncs) {
-    iter.second->Dump(o << iter.first << ": ") << '\n';
+  for (const IntrinsicInterface &f : genericIntrinsicFunction) {
+    f.Dump(o << f.name << ": ") << '\n';
   }
   o << "specific intrinsic functions:\n";
-  for (const auto &iter : specificFuncs) {
-    iter.second->Dump(o << iter.first << ": ");
-    if (const char *g{iter.second->generic}) {
+  for (const SpecificIntrinsicInterface &f : specificIntrinsicFunction) {
+    f.Dump(o << f.name << ": ");
+    if (const char *g{f.generic}) {
       o << " -> " << g;
     }
     o << '\n';
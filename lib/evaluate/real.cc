@@ -16,10 +16,182 @@
 #include "int-power.h"
 #include "../common/idioms.h"
 #include "../parser/characters.h"
+#include <cfenv>
+#include <cfloat>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <optional>
+#include <type_traits>
 
 namespace Fortran::evaluate::value {
 
+bool useHostFloatingPoint{true};
+
+// Maps a Real's word size and precision to a host floating-point type
+// with the same IEEE format, if there is one.
+template<int BITS, int PRECISION> struct HostFloatingType {
+  using type = void;
+};
+#if FLT_EVAL_METHOD == 0  // no excess precision in host arithmetic
+template<> struct HostFloatingType<32, 24> { using type = float; };
+template<> struct HostFloatingType<64, 53> { using type = double; };
+#endif
+
+// Host operations, each with a test of whether its rounded result is
+// exact.  These tests are valid when no value involved is near the
+// denormal range or infinity.
+struct HostAdd {
+  template<typename A> static A Apply(A x, A y) { return x + y; }
+  template<typename A> static bool IsExact(A x, A y, A sum) {
+    A yRounded{sum - x};  // Knuth's TwoSum; the error is exactly
+    A xRounded{sum - yRounded};  // (x - xRounded) + (y - yRounded)
+    return (x - xRounded) + (y - yRounded) == 0;
+  }
+};
+struct HostSubtract {
+  template<typename A> static A Apply(A x, A y) { return x - y; }
+  template<typename A> static bool IsExact(A x, A y, A difference) {
+    return HostAdd::IsExact(x, -y, difference);
+  }
+};
+struct HostMultiply {
+  template<typename A> static A Apply(A x, A y) { return x * y; }
+  template<typename A> static bool IsExact(A x, A y, A product) {
+    return std::fma(x, y, -product) == 0;
+  }
+};
+struct HostDivide {
+  template<typename A> static A Apply(A x, A y) { return x / y; }
+  template<typename A> static bool IsExact(A x, A y, A quotient) {
+    return std::fma(-quotient, y, x) == 0;  // remainder
+  }
+};
+
+// Applies a dyadic operation to two Reals with the host's floating-point
+// unit and determines the same flags as the emulation would.  Returns
+// std::nullopt, so that the emulation is used instead, when there is no
+// host type with the same format, when rounding is not to nearest, or
+// when a NaN operand or a value near the denormal range or infinity is
+// involved; so results never depend on how the host treats NaN payloads,
+// detects underflow, or flushes denormals to zero.
+template<typename OPERATION, typename REAL>
+static std::optional<ValueWithRealFlags<REAL>> HostArithmetic(
+    const REAL &x, const REAL &y, Rounding rounding) {
+  using Host = typename HostFloatingType<REAL::bits, REAL::precision>::type;
+  if constexpr (std::is_void_v<Host> || !REAL::implicitMSB) {
+    return std::nullopt;
+  } else {
+    static_assert(std::numeric_limits<Host>::is_iec559);
+    static_assert(sizeof(Host) * CHAR_BIT == REAL::bits);
+    // Finite nonzero values must have exponents in this range.
+    constexpr std::uint64_t minSafeExponent{2 * REAL::precision + 1};
+    constexpr std::uint64_t maxSafeExponent{REAL::maxExponent - 2};
+    auto isSafe{[&](const REAL &a) {
+      std::uint64_t exponent{a.Exponent()};
+      return a.IsZero() || a.IsInfinite() ||
+          (exponent >= minSafeExponent && exponent <= maxSafeExponent);
+    }};
+    if (!useHostFloatingPoint || rounding != Rounding::TiesToEven ||
+        x.IsNotANumber() || y.IsNotANumber() || !isSafe(x) || !isSafe(y) ||
+        std::fegetround() != FE_TONEAREST) {
+      return std::nullopt;
+    }
+    using UInt = HostUnsignedInt<REAL::bits>;
+    UInt raw{static_cast<UInt>(x.RawBits().ToUInt64())};
+    Host hostX, hostY;
+    std::memcpy(&hostX, &raw, sizeof raw);
+    raw = y.RawBits().ToUInt64();
+    std::memcpy(&hostY, &raw, sizeof raw);
+    Host hostResult{OPERATION::Apply(hostX, hostY)};
+    std::memcpy(&raw, &hostResult, sizeof raw);
+    ValueWithRealFlags<REAL> result{
+        REAL{typename REAL::Word{std::uint64_t{raw}}}, RealFlags{}};
+    bool finiteOperands{!x.IsInfinite() && !y.IsInfinite()};
+    if (result.value.IsNotANumber()) {
+      result.value = REAL::NotANumber();
+      result.flags.set(RealFlag::InvalidArgument);
+    } else if (result.value.IsInfinite()) {
+      if (finiteOperands) {
+        if (y.IsZero()) {
+          result.flags.set(RealFlag::DivideByZero);
+        } else {
+          result.flags.set(RealFlag::Overflow);
+          result.flags.set(RealFlag::Inexact);
+        }
+      }
+    } else if (result.value.IsZero()) {
+      if (finiteOperands && !x.IsZero() && !y.IsZero()) {
+        return std::nullopt;  // cancellation or underflow
+      }
+    } else if (!isSafe(result.value)) {
+      return std::nullopt;
+    } else if (!OPERATION::IsExact(hostX, hostY, hostResult)) {
+      result.flags.set(RealFlag::Inexact);
+    }
+    return result;
+  }
+}
+
+// Applies a dyadic operation elementwise to arrays of Reals.  When the
+// host has a type with the same format and the rounding mode allows, all
+// of the elements are computed in one tight loop by the host's
+// floating-point unit, and each result is kept when its operands and it
+// are finite and clear of the denormal range and infinity, where the
+// exactness test determines the only possible flag.  The other elements
+// are computed one at a time by the scalar operation.
+template<typename OPERATION, typename REAL, typename SCALAR>
+static RealFlags Elementwise(const REAL *x, std::size_t xStride,
+    const REAL *y, std::size_t yStride, REAL *result, std::size_t n,
+    Rounding rounding, SCALAR scalar) {
+  using Host = typename HostFloatingType<REAL::bits, REAL::precision>::type;
+  RealFlags flags;
+  if constexpr (!std::is_void_v<Host> && REAL::implicitMSB) {
+    if (useHostFloatingPoint && rounding == Rounding::TiesToEven &&
+        std::fegetround() == FE_TONEAREST) {
+      using UInt = HostUnsignedInt<REAL::bits>;
+      constexpr UInt magnitude{~(UInt{1} << (REAL::bits - 1))};
+      constexpr UInt minSafe{UInt{2 * REAL::precision + 1}
+          << REAL::significandBits};
+      constexpr UInt maxSafe{UInt{REAL::maxExponent - 1}
+          << REAL::significandBits};  // exclusive
+      bool inexact{false};
+      for (std::size_t j{0}; j < n; ++j) {
+        const REAL &xj{x[j * xStride]}, &yj{y[j * yStride]};
+        UInt rawX{static_cast<UInt>(xj.RawBits().ToUInt64())};
+        UInt rawY{static_cast<UInt>(yj.RawBits().ToUInt64())};
+        Host hostX, hostY;
+        std::memcpy(&hostX, &rawX, sizeof rawX);
+        std::memcpy(&hostY, &rawY, sizeof rawY);
+        Host hostResult{OPERATION::Apply(hostX, hostY)};
+        UInt rawResult;
+        std::memcpy(&rawResult, &hostResult, sizeof rawResult);
+        UInt magX{static_cast<UInt>(rawX & magnitude)};
+        UInt magY{static_cast<UInt>(rawY & magnitude)};
+        UInt magResult{static_cast<UInt>(rawResult & magnitude)};
+        if ((magX == 0 || (magX >= minSafe && magX < maxSafe)) &&
+            (magY == 0 || (magY >= minSafe && magY < maxSafe)) &&
+            magResult >= minSafe && magResult < maxSafe) {
+          result[j] = REAL{typename REAL::Word{std::uint64_t{rawResult}}};
+          inexact |= !OPERATION::IsExact(hostX, hostY, hostResult);
+        } else {
+          result[j] = scalar(xj, yj).AccumulateFlags(flags);
+        }
+      }
+      if (inexact) {
+        flags.set(RealFlag::Inexact);
+      }
+      return flags;
+    }
+  }
+  for (std::size_t j{0}; j < n; ++j) {
+    result[j] = scalar(x[j * xStride], y[j * yStride]).AccumulateFlags(flags);
+  }
+  return flags;
+}
+
 template<typename W, int P, bool IM>
 Relation Real<W, P, IM>::Compare(const Real &y) const {
   if (IsNotANumber() || y.IsNotANumber()) {  // NaN vs x, x vs NaN
@@ -61,6 +233,9 @@ Relation Real<W, P, IM>::Compare(const Real &y) const {
 template<typename W, int P, bool IM>
 ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Add(
     const Real &y, Rounding rounding) const {
+  if (auto host{HostArithmetic<HostAdd>(*this, y, rounding)}) {
+    return *host;
+  }
   ValueWithRealFlags<Real> result;
   if (IsNotANumber() || y.IsNotANumber()) {
     result.value = NotANumber();  // NaN + x -> NaN
@@ -141,6 +316,9 @@ ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Add(
 template<typename W, int P, bool IM>
 ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Multiply(
     const Real &y, Rounding rounding) const {
+  if (auto host{HostArithmetic<HostMultiply>(*this, y, rounding)}) {
+    return *host;
+  }
   ValueWithRealFlags<Real> result;
   if (IsNotANumber() || y.IsNotANumber()) {
     result.value = NotANumber();  // NaN * x -> NaN
@@ -201,6 +379,9 @@ ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Multiply(
 template<typename W, int P, bool IM>
 ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Divide(
     const Real &y, Rounding rounding) const {
+  if (auto host{HostArithmetic<HostDivide>(*this, y, rounding)}) {
+    return *host;
+  }
   ValueWithRealFlags<Real> result;
   if (IsNotANumber() || y.IsNotANumber()) {
     result.value = NotANumber();  // NaN / x -> NaN, x / NaN -> NaN
@@ -266,6 +447,40 @@ ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Divide(
   return result;
 }
 
+template<typename W, int P, bool IM>
+RealFlags Real<W, P, IM>::AddElementwise(const Real *x, std::size_t xStride,
+    const Real *y, std::size_t yStride, Real *result, std::size_t n,
+    Rounding rounding) {
+  return Elementwise<HostAdd>(x, xStride, y, yStride, result, n, rounding,
+      [=](const Real &a, const Real &b) { return a.Add(b, rounding); });
+}
+
+template<typename W, int P, bool IM>
+RealFlags Real<W, P, IM>::SubtractElementwise(const Real *x,
+    std::size_t xStride, const Real *y, std::size_t yStride, Real *result,
+    std::size_t n, Rounding rounding) {
+  return Elementwise<HostSubtract>(x, xStride, y, yStride, result, n,
+      rounding,
+      [=](const Real &a, const Real &b) { return a.Subtract(b, rounding); });
+}
+
+template<typename W, int P, bool IM>
+RealFlags Real<W, P, IM>::MultiplyElementwise(const Real *x,
+    std::size_t xStride, const Real *y, std::size_t yStride, Real *result,
+    std::size_t n, Rounding rounding) {
+  return Elementwise<HostMultiply>(x, xStride, y, yStride, result, n,
+      rounding,
+      [=](const Real &a, const Real &b) { return a.Multiply(b, rounding); });
+}
+
+template<typename W, int P, bool IM>
+RealFlags Real<W, P, IM>::DivideElementwise(const Real *x,
+    std::size_t xStride, const Real *y, std::size_t yStride, Real *result,
+    std::size_t n, Rounding rounding) {
+  return Elementwise<HostDivide>(x, xStride, y, yStride, result, n, rounding,
+      [=](const Real &a, const Real &b) { return a.Divide(b, rounding); });
+}
+
 template<typename W, int P, bool IM>
 RealFlags Real<W, P, IM>::Normalize(bool negative, std::uint64_t exponent,
     const Fraction &fraction, Rounding rounding, RoundingBits *roundingBits) {
@@ -379,9 +594,194 @@ void Real<W, P, IM>::NormalizeAndRound(ValueWithRealFlags<Real> &result,
   result.flags |= result.value.Round(rounding, roundingBits, multiply);
 }
 
+// Decimal conversions for Real kinds with host equivalents are performed
+// by the host when rounding is to nearest.  A decimal significand of up to
+// 19 digits is converted by Clinger's fast path when it and the power of
+// ten are exact host values, and otherwise by the C++ library's
+// from_chars(), which is an Eisel-Lemire implementation in current
+// libraries.  Shortest round-trip formatting uses to_chars().  Other cases,
+// including those whose results are denormal or overflow, are left to the
+// exact multi-precision algorithms.
+
+// Determines whether w*(10**e) is exactly representable with a precision
+// of "precision" bits, barring overflow and underflow.
+static bool IsExactDecimal(std::uint64_t w, int e, int precision) {
+  if (w == 0) {
+    return true;
+  }
+  for (; e < 0; ++e) {
+    if (w % 5 != 0) {
+      return false;
+    }
+    w /= 5;
+  }
+  while ((w & 1) == 0) {
+    w >>= 1;
+  }
+  std::uint64_t limit{std::uint64_t{1} << precision};
+  for (; e > 0 && w < limit; --e) {
+    w *= 5;
+  }
+  return w < limit;
+}
+
+template<typename REAL>
+static std::optional<ValueWithRealFlags<REAL>> HostRead(
+    const char *&p, Rounding rounding) {
+  using Host = typename HostFloatingType<REAL::bits, REAL::precision>::type;
+  if constexpr (std::is_void_v<Host> || !REAL::implicitMSB) {
+    return std::nullopt;
+  } else {
+    if (!useHostFloatingPoint || rounding != Rounding::TiesToEven ||
+        std::fegetround() != FE_TONEAREST) {
+      return std::nullopt;
+    }
+    // Scan the same syntax as Real::Read().
+    const char *q{p};
+    while (*q == ' ') {
+      ++q;
+    }
+    bool isNegative{*q == '-'};
+    if (*q == '-' || *q == '+') {
+      ++q;
+    }
+    std::uint64_t significand{0};
+    int digits{0};
+    int decimalExponent{0};
+    bool inFraction{false};
+    for (;; ++q) {
+      if (*q == '.') {
+        if (inFraction) {
+          break;
+        }
+        inFraction = true;
+      } else if (!parser::IsDecimalDigit(*q)) {
+        break;
+      } else if (digits >= 19) {
+        return std::nullopt;
+      } else {
+        significand = 10 * significand + (*q - '0');
+        digits += significand != 0;  // leading zeros are not significant
+        if (inFraction) {
+          --decimalExponent;
+        }
+      }
+    }
+    if (parser::IsLetter(*q)) {
+      ++q;
+      bool negExpo{*q == '-'};
+      if (*q == '+' || *q == '-') {
+        ++q;
+      }
+      if (!parser::IsDecimalDigit(*q)) {
+        return std::nullopt;
+      }
+      int expo{0};
+      for (; parser::IsDecimalDigit(*q); ++q) {
+        if (expo > 9999) {
+          return std::nullopt;
+        }
+        expo = 10 * expo + (*q - '0');
+      }
+      decimalExponent += negExpo ? -expo : expo;
+    }
+    ValueWithRealFlags<REAL> result;
+    if (significand != 0) {
+      static constexpr double exactPowersOfTen[]{1e0, 1e1, 1e2, 1e3, 1e4,
+          1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+          1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+      constexpr int maxExactPower{REAL::precision <= 24 ? 10 : 22};
+      Host value;
+      if (significand < std::uint64_t{1} << REAL::precision &&
+          decimalExponent >= -maxExactPower &&
+          decimalExponent <= maxExactPower) {
+        Host power{static_cast<Host>(exactPowersOfTen[decimalExponent < 0
+                ? -decimalExponent
+                : decimalExponent])};
+        value = static_cast<Host>(significand);
+        if (decimalExponent < 0) {
+          value /= power;
+        } else {
+          value *= power;
+        }
+      } else {
+#if __cpp_lib_to_chars >= 201611L
+        char buffer[32];
+        char *end{std::to_chars(buffer, buffer + 20, significand).ptr};
+        *end++ = 'e';
+        end = std::to_chars(end, buffer + sizeof buffer, decimalExponent).ptr;
+        if (std::from_chars(buffer, end, value).ec != std::errc{}) {
+          return std::nullopt;  // overflow or underflow
+        }
+#else
+        return std::nullopt;
+#endif
+      }
+      using UInt = HostUnsignedInt<REAL::bits>;
+      UInt raw;
+      std::memcpy(&raw, &value, sizeof raw);
+      result.value = REAL{typename REAL::Word{std::uint64_t{raw}}};
+      if (result.value.IsDenormal() || result.value.IsZero() ||
+          result.value.IsInfinite()) {
+        return std::nullopt;
+      }
+      if (!IsExactDecimal(significand, decimalExponent, REAL::precision)) {
+        result.flags.set(RealFlag::Inexact);
+      }
+    }
+    if (isNegative) {
+      result.value = result.value.Negate();
+    }
+    p = q;
+    return result;
+  }
+}
+
+// Produces the shortest decimal representation that reads back to the
+// same finite, positive value.
+template<typename REAL>
+static std::optional<ValueWithRealFlags<typename REAL::ScaledDecimal>>
+HostScaledDecimal(const REAL &x, Rounding rounding) {
+  using Host = typename HostFloatingType<REAL::bits, REAL::precision>::type;
+#if __cpp_lib_to_chars >= 201611L
+  if constexpr (!std::is_void_v<Host> && REAL::implicitMSB) {
+    if (useHostFloatingPoint && rounding == Rounding::TiesToEven) {
+      using UInt = HostUnsignedInt<REAL::bits>;
+      UInt raw{static_cast<UInt>(x.RawBits().ToUInt64())};
+      Host value;
+      std::memcpy(&value, &raw, sizeof raw);
+      char buffer[32];  // d.dddde-ddd
+      char *end{std::to_chars(buffer, buffer + sizeof buffer, value,
+          std::chars_format::scientific)
+                    .ptr};
+      std::uint64_t integer{0};
+      int digits{0};
+      const char *q{buffer};
+      for (; *q != 'e'; ++q) {
+        if (*q != '.') {
+          integer = 10 * integer + (*q - '0');
+          ++digits;
+        }
+      }
+      q += q[1] == '+' ? 2 : 1;
+      int exponent{0};
+      std::from_chars(q, end, exponent);
+      ValueWithRealFlags<typename REAL::ScaledDecimal> result;
+      result.value.integer = typename REAL::Word{integer};
+      result.value.decimalExponent = exponent - (digits - 1);
+      return result;
+    }
+  }
+#endif
+  return std::nullopt;
+}
+
 template<typename W, int P, bool IM>
 ValueWithRealFlags<Real<W, P, IM>> Real<W, P, IM>::Read(
     const char *&p, Rounding rounding) {
+  if (auto host{HostRead<Real>(p, rounding)}) {
+    return *host;
+  }
   ValueWithRealFlags<Real> result;
   while (*p == ' ') {
     ++p;
@@ -607,6 +1007,9 @@ auto Real<W, P, IM>::AsScaledDecimal(Rounding rounding) const
   if (IsZero()) {
     return result;
   }
+  if (auto host{HostScaledDecimal(*this, rounding)}) {
+    return *host;
+  }
 
   Word fraction{Word::ConvertUnsigned(GetFraction()).value};
   Word asInt{fraction.SHIFTL(bits - precision)};
@@ -19,6 +19,7 @@
 #include "integer.h"
 #include "rounding-bits.h"
 #include <cinttypes>
+#include <cstddef>
 #include <limits>
 #include <ostream>
 #include <string>
@@ -29,6 +30,13 @@
 
 namespace Fortran::evaluate::value {
 
+// Addition, subtraction, multiplication, and division of Real kinds whose
+// format is that of the host's float or double are performed by the host's
+// floating-point unit when the rounding mode allows and no denormal numbers
+// are involved.  Clearing this flag forces the use of the emulation, e.g.
+// for differential testing.
+extern bool useHostFloatingPoint;
+
 // Models IEEE binary floating-point numbers (IEEE 754-2008,
 // ISO/IEC/IEEE 60559.2011).  The first argument to this
 // class template must be (or look like) an instance of Integer<>;
@@ -72,8 +80,8 @@ public:
   constexpr Real &operator=(Real &&) = default;
 
   // TODO ANINT, CEILING, FLOOR, DIM, MAX, MIN, DPROD, FRACTION
-  // HUGE, INT/NINT, MAXEXPONENT, MINEXPONENT, NEAREST, OUT_OF_RANGE,
-  // PRECISION, HUGE, TINY, RRSPACING/SPACING, SCALE, SET_EXPONENT, SIGN
+  // INT/NINT, MAXEXPONENT, MINEXPONENT, NEAREST, OUT_OF_RANGE,
+  // PRECISION, TINY, RRSPACING/SPACING, SCALE, SET_EXPONENT, SIGN
 
   constexpr bool IsNegative() const {
     return !IsNotANumber() && word_.BTEST(bits - 1);
@@ -116,6 +124,22 @@ public:
   ValueWithRealFlags<Real> Divide(
       const Real &, Rounding rounding = defaultRounding) const;
 
+  // Elementwise operations on arrays of n values, for folding:
+  // result[j] = x[j * xStride] op y[j * yStride], so that a stride of zero
+  // broadcasts a scalar operand.  Returns the union of the elements' flags.
+  static RealFlags AddElementwise(const Real *x, std::size_t xStride,
+      const Real *y, std::size_t yStride, Real *result, std::size_t n,
+      Rounding rounding = defaultRounding);
+  static RealFlags SubtractElementwise(const Real *x, std::size_t xStride,
+      const Real *y, std::size_t yStride, Real *result, std::size_t n,
+      Rounding rounding = defaultRounding);
+  static RealFlags MultiplyElementwise(const Real *x, std::size_t xStride,
+      const Real *y, std::size_t yStride, Real *result, std::size_t n,
+      Rounding rounding = defaultRounding);
+  static RealFlags DivideElementwise(const Real *x, std::size_t xStride,
+      const Real *y, std::size_t yStride, Real *result, std::size_t n,
+      Rounding rounding = defaultRounding);
+
   // SQRT(x**2 + y**2) but computed so as to avoid spurious overflow
   // TODO: needed for CABS
   ValueWithRealFlags<Real> HYPOT(
@@ -134,6 +158,12 @@ public:
     }
   }
 
+  // The largest finite value
+  static constexpr Real HUGE() {
+    return {Word{maxExponent - 1}.SHIFTL(significandBits).IOR(
+        Word::MASKR(significandBits))};
+  }
+
   static constexpr Real EPSILON() {
     Real epsilon;
     epsilon.Normalize(false, exponentBias - precision, Fraction::MASKL(1));
@@ -108,7 +108,11 @@ template<typename A> std::optional<std::int64_t> ToInt64(const A &) {
 template<int KIND>
 std::optional<std::int64_t> ToInt64(
     const Constant<Type<TypeCategory::Integer, KIND>> &c) {
-  return {c.value.ToInt64()};
+  if (c.Rank() == 0) {
+    return {c.value().ToInt64()};
+  } else {
+    return std::nullopt;
+  }
 }
 template<int KIND>
 std::optional<std::int64_t> ToInt64(
@@ -102,4 +102,25 @@ DynamicType DynamicType::ResultTypeForMultiply(const DynamicType &that) const {
 std::string SomeDerived::AsFortran() const {
   return "TYPE("s + spec().name().ToString() + ')';
 }
+
+std::size_t TotalElementCount(const ConstantSubscripts &shape) {
+  std::size_t size{1};
+  for (auto extent : shape) {
+    CHECK(extent >= 0);
+    size *= extent;
+  }
+  return size;
+}
+
+std::size_t SubscriptsToOffset(
+    const ConstantSubscripts &subscripts, const ConstantSubscripts &shape) {
+  CHECK(subscripts.size() == shape.size());
+  std::size_t offset{0}, stride{1};
+  for (std::size_t j{0}; j < shape.size(); ++j) {
+    CHECK(subscripts[j] >= 1 && subscripts[j] <= shape[j]);
+    offset += (subscripts[j] - 1) * stride;
+    stride *= shape[j];
+  }
+  return offset;
+}
 }
@@ -34,6 +34,7 @@
 #include <optional>
 #include <string>
 #include <variant>
+#include <vector>
 
 namespace Fortran::semantics {
 class DerivedTypeSpec;
@@ -317,10 +318,70 @@ struct SomeType {
   FOR_EACH_SPECIFIC_TYPE(PREFIX) \
   FOR_EACH_CATEGORY_TYPE(PREFIX)
 
-// Wraps a constant scalar value of a specific intrinsic type
+// Subscripts and extents of constant arrays
+using ConstantSubscript = std::int64_t;
+using ConstantSubscripts = std::vector<ConstantSubscript>;
+
+std::size_t TotalElementCount(const ConstantSubscripts &shape);
+
+// Maps one-based subscripts to the zero-based offset of an element in
+// array element order (column-major).
+std::size_t SubscriptsToOffset(
+    const ConstantSubscripts &subscripts, const ConstantSubscripts &shape);
+
+// The elements of a constant in array element order.  A single element,
+// as in every scalar constant, is held in place, so that scalar constants
+// and the results of folding scalar operations are never allocated on
+// the heap; only arrays of other sizes use a std::vector<>.
+template<typename V> class ConstantValues {
+public:
+  ConstantValues() : u_{std::vector<V>{}} {}
+  explicit ConstantValues(const V &x) : u_{x} {}
+  explicit ConstantValues(V &&x) : u_{std::move(x)} {}
+  explicit ConstantValues(std::vector<V> &&x) {
+    if (x.size() == 1) {
+      u_ = std::move(x.front());
+    } else {
+      u_ = std::move(x);
+    }
+  }
+
+  std::size_t size() const {
+    const auto *array{std::get_if<std::vector<V>>(&u_)};
+    return array != nullptr ? array->size() : 1;
+  }
+  bool empty() const { return size() == 0; }
+  const V *data() const {
+    if (const V *x{std::get_if<V>(&u_)}) {
+      return x;
+    }
+    return std::get<std::vector<V>>(u_).data();
+  }
+  V *data() {
+    if (V *x{std::get_if<V>(&u_)}) {
+      return x;
+    }
+    return std::get<std::vector<V>>(u_).data();
+  }
+  const V *begin() const { return data(); }
+  const V *end() const { return data() + size(); }
+  V *begin() { return data(); }
+  V *end() { return data() + size(); }
+  const V &front() const { return *data(); }
+  V &front() { return *data(); }
+  const V &operator[](std::size_t j) const { return data()[j]; }
+  V &operator[](std::size_t j) { return data()[j]; }
+
+private:
+  std::variant<V, std::vector<V>> u_;
+};
+
+// Wraps a constant value of a specific intrinsic type
 // in a class with its resolved type.
-// N.B. Array constants are represented as array constructors
-// and derived type constants are structure constructors; generic
+// The elements of an array constant are packed contiguously in array
+// element order and described by its shape; a scalar constant has
+// exactly one element and an empty shape.
+// N.B. Derived type constants are structure constructors; generic
 // constants are generic expressions wrapping these constants.
 template<typename T> struct Constant {
   static_assert(T::isSpecificIntrinsicType);
@@ -328,16 +389,37 @@ template<typename T> struct Constant {
   using Value = Scalar<Result>;
 
   CLASS_BOILERPLATE(Constant)
-  template<typename A> Constant(const A &x) : value{x} {}
+  template<typename A> Constant(const A &x) : values{Value{x}} {}
   template<typename A>
   Constant(std::enable_if_t<!std::is_reference_v<A>, A> &&x)
-    : value(std::move(x)) {}
+    : values{Value{std::move(x)}} {}
+  Constant(std::vector<Value> &&x, ConstantSubscripts &&s)
+    : values(std::move(x)), shape(std::move(s)) {
+    CHECK(values.size() == TotalElementCount(shape));
+  }
 
   constexpr DynamicType GetType() const { return Result::GetType(); }
-  int Rank() const { return 0; }
+  int Rank() const { return static_cast<int>(shape.size()); }
+  std::size_t size() const { return values.size(); }
+
+  // The value of a scalar constant
+  const Value &value() const {
+    CHECK(shape.empty());
+    return values.front();
+  }
+  Value &value() {
+    CHECK(shape.empty());
+    return values.front();
+  }
+
+  const Value &At(const ConstantSubscripts &subscripts) const {
+    return values[SubscriptsToOffset(subscripts, shape)];
+  }
+
   std::ostream &AsFortran(std::ostream &) const;
 
-  Value value;
+  ConstantValues<Value> values;  // in array element order
+  ConstantSubscripts shape;  // empty for scalars
 };
 }
 #endif  // FORTRAN_EVALUATE_TYPE_H_
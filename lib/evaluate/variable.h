@@ -279,6 +279,7 @@ public:
 
   const ProcedureDesignator &proc() const { return proc_; }
   const ActualArguments &arguments() const { return arguments_; }
+  ActualArguments &arguments() { return arguments_; }
 
   Expr<SubscriptInteger> LEN() const;
   int Rank() const { return proc_.Rank(); }
@@ -309,7 +310,6 @@ template<typename A> struct FunctionRef : public ProcedureRef {
     }
     return std::nullopt;
   }
-  std::optional<Constant<Result>> Fold(FoldingContext &);  // for intrinsics
 };
 
 FOR_EACH_SPECIFIC_TYPE(extern template struct FunctionRef)
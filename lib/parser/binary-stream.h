@@ -0,0 +1,123 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FORTRAN_PARSER_BINARY_STREAM_H_
+#define FORTRAN_PARSER_BINARY_STREAM_H_
+
+// Defines a compact binary encoding for the saved parse trees of
+// parse-tree-cache.h and the cooked sources on which they depend.
+// Unsigned integers are written seven bits to a byte, least significant
+// group first, with the high bit set in all but the last byte; strings
+// are written as a length followed by their bytes.
+
+#include "../common/idioms.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Fortran::parser {
+
+// 64-bit FNV-1a hashing, used to detect changes to source files and
+// damage to saved data.
+constexpr std::uint64_t initialHash{0xcbf29ce484222325};
+inline std::uint64_t HashBytes(
+    const char *p, std::size_t n, std::uint64_t hash = initialHash) {
+  for (; n-- > 0; ++p) {
+    hash ^= static_cast<unsigned char>(*p);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+class BinaryWriter {
+public:
+  explicit BinaryWriter(std::string &out) : out_{out} {}
+
+  void Put(std::uint64_t n) {
+    for (; n >= 0x80; n >>= 7) {
+      out_ += static_cast<char>(n | 0x80);
+    }
+    out_ += static_cast<char>(n);
+  }
+  void PutSigned(std::int64_t n) {  // small magnitudes stay short
+    auto u{static_cast<std::uint64_t>(n)};
+    Put(n < 0 ? ~(u << 1) : u << 1);
+  }
+  void Put(const char *p, std::size_t n) {
+    Put(static_cast<std::uint64_t>(n));
+    out_.append(p, n);
+  }
+  void Put(const std::string &s) { Put(s.data(), s.size()); }
+
+private:
+  std::string &out_;
+};
+
+// A BinaryReader reads data that were validated as a whole before
+// they were decoded, so malformed data can only have been written by a
+// build whose format differed.  After a read of malformed data, or a
+// call to Fail(), ok() is false and all further reads yield zeroes.
+class BinaryReader {
+public:
+  BinaryReader(const char *at, const char *limit) : at_{at}, limit_{limit} {}
+
+  bool ok() const { return ok_; }
+  bool AtEnd() const { return at_ == limit_; }
+  std::size_t BytesRemaining() const { return limit_ - at_; }
+
+  void Fail() {
+    ok_ = false;
+    at_ = limit_;
+  }
+
+  std::uint64_t Get() {
+    std::uint64_t n{0};
+    for (int shift{0};; shift += 7) {
+      if (at_ == limit_ || shift >= 64) {
+        Fail();
+        return 0;
+      }
+      auto byte{static_cast<unsigned char>(*at_++)};
+      n |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+      if (byte < 0x80) {
+        return n;
+      }
+    }
+  }
+  std::int64_t GetSigned() {
+    std::uint64_t u{Get()};
+    return static_cast<std::int64_t>(u & 1 ? ~(u >> 1) : u >> 1);
+  }
+  std::string GetString() {
+    std::size_t n{GetSize()};
+    std::string result{at_, n};
+    at_ += n;
+    return result;
+  }
+  // Returns a count of things that each take at least one byte.
+  std::size_t GetSize() {
+    std::uint64_t n{Get()};
+    if (n > BytesRemaining()) {
+      Fail();
+      return 0;
+    }
+    return static_cast<std::size_t>(n);
+  }
+
+private:
+  const char *at_, *limit_;
+  bool ok_{true};
+};
+}
+#endif  // FORTRAN_PARSER_BINARY_STREAM_H_
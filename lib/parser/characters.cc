@@ -14,10 +14,29 @@
 
 #include "characters.h"
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <optional>
 
 namespace Fortran::parser {
 
+std::size_t LeadingASCIIBytes(const char *p, std::size_t bytes) {
+  // Test eight bytes at a time for any high bits, then finish bytewise.
+  static constexpr std::uint64_t highBits{0x8080808080808080};
+  std::size_t j{0};
+  for (; j + sizeof highBits <= bytes; j += sizeof highBits) {
+    std::uint64_t word;
+    std::memcpy(&word, p + j, sizeof word);
+    if ((word & highBits) != 0) {
+      break;
+    }
+  }
+  while (j < bytes && (p[j] & 0x80) == 0) {
+    ++j;
+  }
+  return j;
+}
+
 std::optional<int> UTF8CharacterBytes(const char *p) {
   if ((*p & 0x80) == 0) {
     return {1};
@@ -72,6 +91,12 @@ std::optional<std::size_t> CountCharacters(
   std::size_t chars{0};
   const char *limit{p + bytes};
   while (p < limit) {
+    std::size_t ascii{LeadingASCIIBytes(p, limit - p)};
+    chars += ascii;
+    p += ascii;
+    if (p >= limit) {
+      break;
+    }
     ++chars;
     std::optional<int> cb{cbf(p)};
     if (!cb.has_value()) {
@@ -112,19 +137,27 @@ std::string QuoteCharacterLiteral(
 
 std::optional<std::u32string> DecodeUTF8(const std::string &s) {
   std::u32string result;
+  result.reserve(s.size());
   const std::uint8_t *p{reinterpret_cast<const std::uint8_t *>(s.data())};
   for (auto bytes{s.size()}; bytes != 0;) {
+    auto ascii{LeadingASCIIBytes(reinterpret_cast<const char *>(p), bytes)};
+    if (ascii > 0) {
+      result.append(p, p + ascii);
+      p += ascii;
+      bytes -= ascii;
+      continue;
+    }
     decltype(bytes) charBytes{1};
     char32_t ch{*p++};
     if ((ch & 0xc0) > 0x40) {
-      if ((ch & 0xf8) == 0xf0 && bytes >= 4 && ch > 0xf0 &&
+      if ((ch & 0xf8) == 0xf0 && bytes >= 4 && (ch > 0xf0 || p[0] >= 0x90) &&
           ((p[0] | p[1] | p[2]) & 0xc0) == 0x80) {
         charBytes = 4;
         ch = ((ch & 7) << 6) | (*p++ & 0x3f);
         ch = (ch << 6) | (*p++ & 0x3f);
         ch = (ch << 6) | (*p++ & 0x3f);
-      } else if ((ch & 0xf0) == 0xe0 && bytes >= 3 && ch > 0xe0 &&
-          ((p[0] | p[1]) & 0xc0) == 0x80) {
+      } else if ((ch & 0xf0) == 0xe0 && bytes >= 3 &&
+          (ch > 0xe0 || p[0] >= 0xa0) && ((p[0] | p[1]) & 0xc0) == 0x80) {
         charBytes = 3;
         ch = ((ch & 0xf) << 6) | (*p++ & 0x3f);
         ch = (ch << 6) | (*p++ & 0x3f);
@@ -136,6 +169,7 @@ std::optional<std::u32string> DecodeUTF8(const std::string &s) {
         return std::nullopt;  // not valid UTF-8
       }
     }
+    result += ch;
     bytes -= charBytes;
   }
   return {result};
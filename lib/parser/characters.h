@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <optional>
 #include <string>
+#include <type_traits>
 
 namespace Fortran::parser {
 
@@ -180,10 +181,40 @@ std::string QuoteCharacterLiteral(const std::u16string &,
 std::string QuoteCharacterLiteral(const std::u32string &,
     bool doubleDoubleQuotes = true, bool doubleBackslash = true);
 
+// Counts the bytes before the first one with its high bit set; these are
+// single-byte characters in both UTF-8 and EUC-JP, so runs of them needn't
+// be decoded one at a time.
+std::size_t LeadingASCIIBytes(const char *, std::size_t bytes);
+
 std::optional<int> UTF8CharacterBytes(const char *);
 std::optional<int> EUC_JPCharacterBytes(const char *);
 std::optional<std::size_t> CountCharacters(
     const char *, std::size_t bytes, std::optional<int> (*)(const char *));
 std::optional<std::u32string> DecodeUTF8(const std::string &);
+
+// Formats an integer in decimal without allocating, and passes its
+// characters, with a leading minus sign if it is negative, to put(p, bytes).
+template<typename INT, typename FUNC>
+void FormatDecimal(INT x, const FUNC &put) {
+  char digits[3 * sizeof x + 1];  // enough for the digits and a sign
+  char *end{digits + sizeof digits}, *p{end};
+  using Unsigned = std::make_unsigned_t<INT>;
+  Unsigned magnitude{static_cast<Unsigned>(x)};
+  bool negative{false};
+  if constexpr (std::is_signed_v<INT>) {
+    if (x < 0) {
+      negative = true;
+      magnitude = Unsigned{0} - magnitude;
+    }
+  }
+  do {
+    *--p = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (negative) {
+    *--p = '-';
+  }
+  put(p, end - p);
+}
 }
 #endif  // FORTRAN_PARSER_CHARACTERS_H_
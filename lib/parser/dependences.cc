@@ -0,0 +1,206 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dependences.h"
+#include "characters.h"
+#include <cstring>
+#include <optional>
+
+namespace Fortran::parser {
+
+// Recognizes the few statements that matter in one statement of cooked
+// characters.  Cooked text is already in lower case outside character
+// literals; blanks have been removed from fixed form source and compressed
+// to single blanks in free form source, so keywords are matched without
+// embedded blanks and a blank, when present, may only separate tokens.
+class StatementRecognizer {
+public:
+  StatementRecognizer(const char *at, const char *limit, Dependences &deps)
+    : at_{at}, limit_{limit}, deps_{deps} {}
+
+  void Recognize() {
+    SkipBlanks();
+    while (at_ < limit_ && IsDecimalDigit(*at_)) {
+      ++at_;  // statement label
+    }
+    SkipBlanks();
+    if (Keyword("submodule")) {
+      Submodule();
+    } else if (Keyword("module")) {
+      Module();
+    } else if (Keyword("use")) {
+      Use();
+    }
+  }
+
+private:
+  bool AtEnd() const { return at_ >= limit_; }
+
+  bool SkipBlanks() {
+    const char *start{at_};
+    while (at_ < limit_ && *at_ == ' ') {
+      ++at_;
+    }
+    return at_ > start;
+  }
+
+  bool Keyword(const char *keyword) {
+    std::size_t n{std::strlen(keyword)};
+    if (static_cast<std::size_t>(limit_ - at_) >= n &&
+        std::memcmp(at_, keyword, n) == 0) {
+      at_ += n;
+      return true;
+    }
+    return false;
+  }
+
+  bool Punctuation(const char *punct) {
+    SkipBlanks();
+    return Keyword(punct);
+  }
+
+  std::optional<std::string> Name() {
+    SkipBlanks();
+    if (AtEnd() || !IsLegalIdentifierStart(*at_)) {
+      return std::nullopt;
+    }
+    const char *start{at_};
+    while (at_ < limit_ && IsLegalInIdentifier(*at_)) {
+      ++at_;
+    }
+    return std::string{start, static_cast<std::size_t>(at_ - start)};
+  }
+
+  bool IsFinished() {
+    SkipBlanks();
+    return AtEnd();
+  }
+
+  // MODULE name; but not MODULE PROCEDURE, MODULE FUNCTION, &c.
+  void Module() {
+    bool blank{SkipBlanks()};
+    std::optional<std::string> name{Name()};
+    if (!name.has_value() || !IsFinished()) {
+      return;
+    }
+    if (!blank) {
+      // Fixed form: the blank that would have separated a prefix from
+      // a following name is gone.
+      for (const char *prefix : {"procedure", "function", "subroutine"}) {
+        if (name->find(prefix) == 0) {
+          return;
+        }
+      }
+    }
+    deps_.providedModules.insert(*name);
+  }
+
+  // SUBMODULE ( ancestor [: parent] ) name
+  void Submodule() {
+    if (!Punctuation("(")) {
+      return;
+    }
+    std::optional<std::string> ancestor{Name()};
+    if (!ancestor.has_value()) {
+      return;
+    }
+    std::optional<std::string> parent;
+    if (Punctuation(":")) {
+      parent = Name();
+      if (!parent.has_value()) {
+        return;
+      }
+    }
+    if (!Punctuation(")")) {
+      return;
+    }
+    std::optional<std::string> name{Name()};
+    if (!name.has_value() || !IsFinished()) {
+      return;
+    }
+    deps_.requiredModules.insert(*ancestor);
+    if (parent.has_value()) {
+      deps_.requiredModules.insert(*ancestor + '-' + *parent);
+    }
+    deps_.providedModules.insert(*ancestor + '-' + *name);
+  }
+
+  // USE [[, nature] ::] name [, rename-list | , ONLY: only-list]
+  void Use() {
+    bool isIntrinsic{false};
+    if (Punctuation(",")) {
+      std::optional<std::string> nature{Name()};
+      if (!nature.has_value() || !Punctuation("::")) {
+        return;
+      }
+      isIntrinsic = *nature == "intrinsic";
+    } else {
+      Punctuation("::");
+    }
+    std::optional<std::string> name{Name()};
+    if (!name.has_value()) {
+      return;
+    }
+    if (IsFinished() || *at_ == ',') {
+      if (!isIntrinsic) {
+        deps_.requiredModules.insert(*name);
+      }
+    }
+  }
+
+  const char *at_;
+  const char *limit_;
+  Dependences &deps_;
+};
+
+Dependences ScanDependences(const CookedSource &cooked) {
+  Dependences result;
+  const std::string &data{cooked.data()};
+  const char *p{data.data()};
+  const char *limit{p + data.size()};
+  const char *statementStart{p};
+  char quote{'\0'};
+  bool isDirective{false};
+  for (; p < limit; ++p) {
+    char ch{*p};
+    if (quote != '\0') {
+      if (ch == quote) {
+        quote = '\0';  // a doubled quote just reenters the literal
+      } else if (ch == '\n') {
+        quote = '\0';
+      }
+    } else if (ch == '\'' || ch == '"') {
+      quote = ch;
+    } else if (ch == '!') {
+      // With comments gone, only compiler directive lines contain '!'
+      // outside character literals.
+      isDirective = true;
+    }
+    if (ch == '\n' || (ch == ';' && quote == '\0' && !isDirective)) {
+      if (!isDirective) {
+        StatementRecognizer{statementStart, p, result}.Recognize();
+      }
+      statementStart = p + 1;
+      if (ch == '\n') {
+        isDirective = false;
+      }
+    }
+  }
+  for (const std::string &name : result.providedModules) {
+    result.requiredModules.erase(name);
+  }
+  result.includedFiles = cooked.allSources().GetIncludedFilePaths();
+  return result;
+}
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FORTRAN_PARSER_DEPENDENCES_H_
+#define FORTRAN_PARSER_DEPENDENCES_H_
+
+// Extracts the compilation ordering dependences of a prescanned source
+// file without parsing it.  The prescanner has already dealt with
+// conditional compilation, INCLUDE lines, continuations, comments, and
+// case, so only a small recognizer for MODULE, SUBMODULE, and USE
+// statements needs to be applied to each statement in the cooked
+// character stream.
+
+#include "provenance.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Fortran::parser {
+
+struct Dependences {
+  // Module file base names, lower case; a submodule's name is prefixed
+  // with its ancestor module's name and a dash, as in module file names.
+  std::set<std::string> providedModules;
+  std::set<std::string> requiredModules;  // excludes those provided here
+  std::vector<std::string> includedFiles;  // INCLUDE and #include paths
+};
+
+Dependences ScanDependences(const CookedSource &);
+}
+#endif  // FORTRAN_PARSER_DEPENDENCES_H_
@@ -31,6 +31,7 @@
 #include "user-state.h"
 #include <cinttypes>
 #include <cstdio>
+#include <cstring>
 #include <functional>
 #include <list>
 #include <optional>
@@ -1630,6 +1631,107 @@ constexpr auto level1Expr{sourced(first(
     extension<LanguageFeature::SignedPrimary>(
         construct<Expr>(construct<Expr::Negate>("-" >> primary)))))};
 
+// The operators of levels 2 through 5 and the defined binary operators
+// are parsed by a single precedence climbing parser (OperatorExpr, below)
+// rather than by a cascade of parsers, one per level, each of which would
+// otherwise have to attempt all of its operators, and then fail, before
+// every operand.  The next operator is recognized by peeking at the
+// cooked characters; it is only then consumed, with the same effects on
+// the parse state as the corresponding token parser would have.
+// The parse trees, including their source extents, are the same as those
+// of the grammar's productions, which are cited below.
+enum class ExprOperator {
+  None, Power, Multiply, Divide, Add, Subtract, Concat,
+  LT, LE, EQ, NE, AlternativeNE, GE, GT, NOT, AND, OR, EQV, NEQV, XOR,
+  OtherDotted  // .NAME. that might be a defined operator
+};
+
+// Returns the operator after any blanks at the current position,
+// and the number of characters in its token.
+inline ExprOperator PeekAtExprOperator(
+    const ParseState &state, std::size_t &length) {
+  const char *p{state.GetLocation()};
+  const char *limit{p + state.BytesRemaining()};
+  while (p < limit && *p == ' ') {
+    ++p;
+  }
+  length = 0;
+  if (p == limit) {
+    return ExprOperator::None;
+  }
+  char next{p + 1 < limit ? p[1] : '\0'};
+  length = 1;
+  switch (*p) {
+  case '*':
+    if (next == '*') {
+      length = 2;
+      return ExprOperator::Power;
+    }
+    return ExprOperator::Multiply;
+  case '/':
+    if (next == '/' || next == '=') {
+      length = 2;
+      return next == '/' ? ExprOperator::Concat : ExprOperator::NE;
+    }
+    return ExprOperator::Divide;
+  case '+': return ExprOperator::Add;
+  case '-': return ExprOperator::Subtract;
+  case '<':
+    if (next == '=' || next == '>') {
+      length = 2;
+      return next == '=' ? ExprOperator::LE : ExprOperator::AlternativeNE;
+    }
+    return ExprOperator::LT;
+  case '>':
+    if (next == '=') {
+      length = 2;
+      return ExprOperator::GE;
+    }
+    return ExprOperator::GT;
+  case '=':
+    if (next == '=') {
+      length = 2;
+      return ExprOperator::EQ;
+    }
+    return ExprOperator::None;
+  case '.': {
+    const char *q{p + 1};
+    while (q < limit && *q >= 'a' && *q <= 'z') {
+      ++q;
+    }
+    if (q == limit || *q != '.') {
+      return ExprOperator::OtherDotted;
+    }
+    length = q + 1 - p;
+    static constexpr std::pair<const char *, ExprOperator> dotted[]{
+        {"lt", ExprOperator::LT}, {"le", ExprOperator::LE},
+        {"eq", ExprOperator::EQ}, {"ne", ExprOperator::NE},
+        {"ge", ExprOperator::GE}, {"gt", ExprOperator::GT},
+        {"not", ExprOperator::NOT}, {"and", ExprOperator::AND},
+        {"or", ExprOperator::OR}, {"eqv", ExprOperator::EQV},
+        {"neqv", ExprOperator::NEQV}, {"xor", ExprOperator::XOR}};
+    std::size_t nameLength{length - 2};
+    for (const auto &[name, op] : dotted) {
+      if (std::strlen(name) == nameLength &&
+          std::memcmp(name, p + 1, nameLength) == 0) {
+        return op;
+      }
+    }
+    return ExprOperator::OtherDotted;
+  }
+  default: return ExprOperator::None;
+  }
+}
+
+// Consumes an operator token whose length was returned by
+// PeekAtExprOperator() as a TokenStringMatch would.
+inline void ConsumeExprOperator(ParseState &state, std::size_t length) {
+  space.Parse(state);
+  state.UncheckedAdvance(length);
+  state.set_anyTokenMatched();
+  space.Parse(state);
+}
+
 // R1004 mult-operand -> level-1-expr [power-op mult-operand]
 // R1007 power-op -> **
 // Exponentiation (**) is Fortran's only right-associative binary operation.
@@ -1644,8 +1746,9 @@ static constexpr auto multOperand{sourced(MultOperand{})};
 inline std::optional<Expr> MultOperand::Parse(ParseState &state) {
   std::optional<Expr> result{level1Expr.Parse(state)};
   if (result) {
-    static constexpr auto op{attempt("**"_tok)};
-    if (op.Parse(state)) {
+    std::size_t length;
+    if (PeekAtExprOperator(state, length) == ExprOperator::Power) {
+      ConsumeExprOperator(state, length);
       std::function<Expr(Expr &&)> power{[&result](Expr &&right) {
         return Expr{Expr::Power(std::move(result).value(), std::move(right))};
       }};
@@ -1658,252 +1761,308 @@ inline std::optional<Expr> MultOperand::Parse(ParseState &state) {
 
 // R1005 add-operand -> [add-operand mult-op] mult-operand
 // R1008 mult-op -> * | /
-// The left recursion in the grammar is implemented iteratively.
-constexpr struct AddOperand {
-  using resultType = Expr;
-  constexpr AddOperand() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    std::optional<Expr> result{multOperand.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> multiply{[&result](Expr &&right) {
-        return Expr{
-            Expr::Multiply(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> divide{[&result](Expr &&right) {
-        return Expr{Expr::Divide(std::move(result).value(), std::move(right))};
-      }};
-      auto more{attempt(sourced("*" >> applyLambda(multiply, multOperand) ||
-          "/" >> applyLambda(divide, multOperand)))};
-      while (std::optional<Expr> next{more.Parse(state)}) {
-        result = std::move(next);
-      }
-    }
-    return result;
-  }
-} addOperand;
-
 // R1006 level-2-expr -> [[level-2-expr] add-op] add-operand
 // R1009 add-op -> + | -
-// These are left-recursive productions, implemented iteratively.
-// Note that standard Fortran admits a unary + or - to appear only here,
-// by means of a missing first operand; e.g., 2*-3 is valid in C but not
-// standard Fortran.  We accept unary + and - to appear before any primary
-// as an extension.
-constexpr struct Level2Expr {
-  using resultType = Expr;
-  constexpr Level2Expr() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    static constexpr auto unary{
-        sourced(
-            construct<Expr>(construct<Expr::UnaryPlus>("+" >> addOperand)) ||
-            construct<Expr>(construct<Expr::Negate>("-" >> addOperand))) ||
-        addOperand};
-    std::optional<Expr> result{unary.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> add{[&result](Expr &&right) {
-        return Expr{Expr::Add(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> subtract{[&result](Expr &&right) {
-        return Expr{
-            Expr::Subtract(std::move(result).value(), std::move(right))};
-      }};
-      auto more{attempt(sourced("+" >> applyLambda(add, addOperand) ||
-          "-" >> applyLambda(subtract, addOperand)))};
-      while (std::optional<Expr> next{more.Parse(state)}) {
-        result = std::move(next);
-      }
-    }
-    return result;
-  }
-} level2Expr;
-
 // R1010 level-3-expr -> [level-3-expr concat-op] level-2-expr
 // R1011 concat-op -> //
-// Concatenation (//) is left-associative for parsing performance, although
-// one would never notice if it were right-associated.
-constexpr struct Level3Expr {
-  using resultType = Expr;
-  constexpr Level3Expr() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    std::optional<Expr> result{level2Expr.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> concat{[&result](Expr &&right) {
-        return Expr{Expr::Concat(std::move(result).value(), std::move(right))};
-      }};
-      auto more{attempt(sourced("//" >> applyLambda(concat, level2Expr)))};
-      while (std::optional<Expr> next{more.Parse(state)}) {
-        result = std::move(next);
-      }
-    }
-    return result;
-  }
-} level3Expr;
-
 // R1012 level-4-expr -> [level-3-expr rel-op] level-3-expr
 // R1013 rel-op ->
 //         .EQ. | .NE. | .LT. | .LE. | .GT. | .GE. |
 //          == | /= | < | <= | > | >=  @ | <>
-// N.B. relations are not recursive (i.e., LOGICAL is not ordered)
-constexpr struct Level4Expr {
-  using resultType = Expr;
-  constexpr Level4Expr() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    std::optional<Expr> result{level3Expr.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> lt{[&result](Expr &&right) {
-        return Expr{Expr::LT(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> le{[&result](Expr &&right) {
-        return Expr{Expr::LE(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> eq{[&result](Expr &&right) {
-        return Expr{Expr::EQ(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> ne{[&result](Expr &&right) {
-        return Expr{Expr::NE(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> ge{[&result](Expr &&right) {
-        return Expr{Expr::GE(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> gt{[&result](Expr &&right) {
-        return Expr{Expr::GT(std::move(result).value(), std::move(right))};
-      }};
-      auto more{attempt(
-          sourced((".LT."_tok || "<"_tok) >> applyLambda(lt, level3Expr) ||
-              (".LE."_tok || "<="_tok) >> applyLambda(le, level3Expr) ||
-              (".EQ."_tok || "=="_tok) >> applyLambda(eq, level3Expr) ||
-              (".NE."_tok || "/="_tok ||
-                  extension<LanguageFeature::AlternativeNE>(
-                      "<>"_tok /* PGI/Cray extension; Cray also has .LG. */)) >>
-                  applyLambda(ne, level3Expr) ||
-              (".GE."_tok || ">="_tok) >> applyLambda(ge, level3Expr) ||
-              (".GT."_tok || ">"_tok) >> applyLambda(gt, level3Expr)))};
-      if (std::optional<Expr> next{more.Parse(state)}) {
-        return next;
-      }
-    }
-    return result;
-  }
-} level4Expr;
-
 // R1014 and-operand -> [not-op] level-4-expr
+// R1015 or-operand -> [or-operand and-op] and-operand
+// R1016 equiv-operand -> [equiv-operand or-op] or-operand
+// R1017 level-5-expr -> [level-5-expr equiv-op] equiv-operand
 // R1018 not-op -> .NOT.
+// R1019 and-op -> .AND.
+// R1020 or-op -> .OR.
+// R1021 equiv-op -> .EQV. | .NEQV.
+// R1022 expr -> [expr defined-binary-op] level-5-expr
+// The left recursion in these productions is implemented iteratively;
+// all of these binary operators associate leftwards, apart from the
+// relations, which are not recursive (i.e., LOGICAL is not ordered).
+// Concatenation (//) is left-associative for parsing performance, although
+// one would never notice if it were right-associated.
+// Note that standard Fortran admits a unary + or - to appear only at the
+// beginning of a level-2-expr, by means of a missing first operand; e.g.,
+// 2*-3 is valid in C but not standard Fortran.  We accept unary + and -
+// to appear before any primary as an extension (see level1Expr).
 // N.B. Fortran's .NOT. binds less tightly than its comparison operators do.
 // PGI/Intel extension: accept multiple .NOT. operators
-constexpr struct AndOperand {
+// PGI/Cray extension: <> as a synonym for .NE.; Cray also has .LG.
+// Extension: .XOR. as synonym for .NEQV.
+// A dotted name that is not an applicable intrinsic operator, or whose
+// right operand cannot be parsed, is treated as a defined binary operator,
+// as the grammar would.
+class OperatorExpr {
+public:
   using resultType = Expr;
-  constexpr AndOperand() {}
-  static inline std::optional<Expr> Parse(ParseState &);
-} andOperand;
-
-inline std::optional<Expr> AndOperand::Parse(ParseState &state) {
-  static constexpr auto op{attempt(".NOT."_tok)};
-  int complements{0};
-  while (op.Parse(state)) {
-    ++complements;
-  }
-  std::optional<Expr> result{level4Expr.Parse(state)};
-  if (result.has_value()) {
-    while (complements-- > 0) {
-      result = Expr{Expr::NOT{std::move(*result)}};
+  // Operator precedences, from the loosest to the tightest binding
+  enum Precedence {
+    DefinedBinaryPrecedence,  // expr
+    EquivPrecedence,  // level-5-expr
+    OrPrecedence,  // equiv-operand
+    AndPrecedence,  // or-operand, and also and-operand with .NOT.
+    RelationalPrecedence,  // level-4-expr
+    ConcatPrecedence,  // level-3-expr
+    AddPrecedence,  // level-2-expr
+    MultPrecedence,  // add-operand
+    OperandPrecedence,  // mult-operand
+  };
+  constexpr OperatorExpr(const OperatorExpr &) = default;
+  // Parses an expression whose operators bind at least as tightly as
+  // "minimum"; e.g., an add-operand when it is MultPrecedence.
+  constexpr OperatorExpr(Precedence minimum) : minimum_{minimum} {}
+  inline std::optional<Expr> Parse(ParseState &) const;
+
+private:
+  static constexpr Precedence PrecedenceOf(ExprOperator op) {
+    switch (op) {
+    case ExprOperator::Multiply:
+    case ExprOperator::Divide: return MultPrecedence;
+    case ExprOperator::Add:
+    case ExprOperator::Subtract: return AddPrecedence;
+    case ExprOperator::Concat: return ConcatPrecedence;
+    case ExprOperator::LT:
+    case ExprOperator::LE:
+    case ExprOperator::EQ:
+    case ExprOperator::NE:
+    case ExprOperator::AlternativeNE:
+    case ExprOperator::GE:
+    case ExprOperator::GT: return RelationalPrecedence;
+    case ExprOperator::AND: return AndPrecedence;
+    case ExprOperator::OR: return OrPrecedence;
+    case ExprOperator::EQV:
+    case ExprOperator::NEQV:
+    case ExprOperator::XOR: return EquivPrecedence;
+    default: return DefinedBinaryPrecedence;  // not an intrinsic operator
     }
   }
-  return result;
-}
+  template<typename OPERATION>
+  static Expr Combine(std::optional<Expr> &left, std::optional<Expr> &right) {
+    return Expr{OPERATION(std::move(*left), std::move(*right))};
+  }
+  static inline std::optional<Expr> ParseBinary(ParseState &, ExprOperator,
+      std::size_t length, std::optional<Expr> &left);
+  static inline std::optional<Expr> ParseDefinedBinary(
+      ParseState &, std::optional<Expr> &left);
 
-// R1015 or-operand -> [or-operand and-op] and-operand
-// R1019 and-op -> .AND.
-// .AND. is left-associative
-constexpr struct OrOperand {
-  using resultType = Expr;
-  constexpr OrOperand() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    std::optional<Expr> result{andOperand.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> logicalAnd{[&result](Expr &&right) {
-        return Expr{Expr::AND(std::move(result).value(), std::move(right))};
-      }};
-      auto more{
-          attempt(sourced(".AND." >> applyLambda(logicalAnd, andOperand)))};
-      while (std::optional<Expr> next{more.Parse(state)}) {
-        result = std::move(next);
+  Precedence minimum_;
+};
+
+inline std::optional<Expr> OperatorExpr::Parse(ParseState &state) const {
+  std::optional<Expr> result;
+  Precedence resultPrecedence{OperandPrecedence};
+  std::size_t length;
+  if (minimum_ <= RelationalPrecedence) {  // and-operand
+    int complements{0};
+    while (PeekAtExprOperator(state, length) == ExprOperator::NOT) {
+      ConsumeExprOperator(state, length);
+      ++complements;
+    }
+    if (complements > 0) {
+      result = OperatorExpr{RelationalPrecedence}.Parse(state);
+      if (!result.has_value()) {
+        return result;
       }
+      while (complements-- > 0) {
+        result = Expr{Expr::NOT{std::move(*result)}};
+      }
+      resultPrecedence = AndPrecedence;
     }
-    return result;
   }
-} orOperand;
-
-// R1016 equiv-operand -> [equiv-operand or-op] or-operand
-// R1020 or-op -> .OR.
-// .OR. is left-associative
-constexpr struct EquivOperand {
-  using resultType = Expr;
-  constexpr EquivOperand() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    std::optional<Expr> result{orOperand.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> logicalOr{[&result](Expr &&right) {
-        return Expr{Expr::OR(std::move(result).value(), std::move(right))};
-      }};
-      auto more{attempt(sourced(".OR." >> applyLambda(logicalOr, orOperand)))};
-      while (std::optional<Expr> next{more.Parse(state)}) {
-        result = std::move(next);
+  if (!result.has_value()) {
+    if (minimum_ > AddPrecedence) {
+      result = multOperand.Parse(state);
+      if (!result.has_value()) {
+        return result;
+      }
+    } else {  // level-2-expr with an optional unary + or -
+      static constexpr OperatorExpr addOperand{MultPrecedence};
+      Messages messages{std::move(state.messages())};
+      ParseState backtrack{state};
+      const char *start{state.GetLocation()};
+      ExprOperator unary{PeekAtExprOperator(state, length)};
+      std::optional<ParseState> signedFailure;
+      if (unary == ExprOperator::Add || unary == ExprOperator::Subtract) {
+        ConsumeExprOperator(state, length);
+        if (std::optional<Expr> operand{addOperand.Parse(state)}) {
+          if (unary == ExprOperator::Add) {
+            result = Expr{Expr::UnaryPlus{std::move(*operand)}};
+          } else {
+            result = Expr{Expr::Negate{std::move(*operand)}};
+          }
+          result->source = CharBlock{start, state.GetLocation()};
+          resultPrecedence = AddPrecedence;
+        } else {
+          signedFailure.emplace(std::move(state));
+          state = backtrack;
+          state.messages() = Messages{};
+        }
+      }
+      if (!result.has_value()) {
+        result = multOperand.Parse(state);
+      }
+      if (!result.has_value()) {
+        // Leave the state as the grammar's alternatives ("+" add-operand,
+        // "-" add-operand, and add-operand) would in their failure,
+        // without reparsing anything; failed productions may have been
+        // logged, and would not fail in the same way when retried.
+        ParseState plus{backtrack}, minus{backtrack};
+        if (unary == ExprOperator::Add) {
+          plus = std::move(*signedFailure);
+        } else {
+          "+"_tok.Parse(plus);
+        }
+        if (unary == ExprOperator::Subtract) {
+          minus = std::move(*signedFailure);
+        } else {
+          "-"_tok.Parse(minus);
+        }
+        minus.CombineFailedParses(std::move(plus));
+        state.CombineFailedParses(std::move(minus));
+      }
+      state.messages().Restore(std::move(messages));
+      if (!result.has_value()) {
+        return result;
       }
     }
-    return result;
   }
-} equivOperand;
-
-// R1017 level-5-expr -> [level-5-expr equiv-op] equiv-operand
-// R1021 equiv-op -> .EQV. | .NEQV.
-// Logical equivalence is left-associative.
-// Extension: .XOR. as synonym for .NEQV.
-constexpr struct Level5Expr {
-  using resultType = Expr;
-  constexpr Level5Expr() {}
-  static inline std::optional<Expr> Parse(ParseState &state) {
-    std::optional<Expr> result{equivOperand.Parse(state)};
-    if (result) {
-      std::function<Expr(Expr &&)> eqv{[&result](Expr &&right) {
-        return Expr{Expr::EQV(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> neqv{[&result](Expr &&right) {
-        return Expr{Expr::NEQV(std::move(result).value(), std::move(right))};
-      }};
-      std::function<Expr(Expr &&)> logicalXor{[&result](Expr &&right) {
-        return Expr{Expr::XOR(std::move(result).value(), std::move(right))};
-      }};
-      auto more{attempt(sourced(".EQV." >> applyLambda(eqv, equivOperand) ||
-          ".NEQV." >> applyLambda(neqv, equivOperand) ||
-          extension<LanguageFeature::XOROperator>(
-              ".XOR." >> applyLambda(logicalXor, equivOperand))))};
-      while (std::optional<Expr> next{more.Parse(state)}) {
+  while (true) {
+    ExprOperator op{PeekAtExprOperator(state, length)};
+    Precedence precedence{PrecedenceOf(op)};
+    if (precedence != DefinedBinaryPrecedence && precedence >= minimum_ &&
+        (precedence == RelationalPrecedence ? precedence < resultPrecedence
+                                            : precedence <= resultPrecedence)) {
+      if (std::optional<Expr> next{ParseBinary(state, op, length, result)}) {
+        result = std::move(next);
+        resultPrecedence = precedence;
+        continue;
+      }
+    }
+    if (minimum_ == DefinedBinaryPrecedence &&
+        (op == ExprOperator::OtherDotted || length > 2 /* .NAME. */)) {
+      if (std::optional<Expr> next{ParseDefinedBinary(state, result)}) {
         result = std::move(next);
+        resultPrecedence = DefinedBinaryPrecedence;
+        continue;
       }
     }
     return result;
   }
-} level5Expr;
+}
 
-// R1022 expr -> [expr defined-binary-op] level-5-expr
-// Defined binary operators associate leftwards.
-template<> inline std::optional<Expr> Parser<Expr>::Parse(ParseState &state) {
-  std::optional<Expr> result{level5Expr.Parse(state)};
-  if (result) {
-    std::function<Expr(DefinedOpName &&, Expr &&)> defBinOp{
-        [&result](DefinedOpName &&op, Expr &&right) {
-          return Expr{Expr::DefinedBinary(
-              std::move(op), std::move(result).value(), std::move(right))};
-        }};
-    auto more{
-        attempt(sourced(applyLambda(defBinOp, definedOpName, level5Expr)))};
-    while (std::optional<Expr> next{more.Parse(state)}) {
-      result = std::move(next);
+// Parses an intrinsic binary operator and its right operand, returning
+// the operation on success; otherwise, the state is unchanged.
+inline std::optional<Expr> OperatorExpr::ParseBinary(ParseState &state,
+    ExprOperator op, std::size_t length, std::optional<Expr> &left) {
+  Messages messages{std::move(state.messages())};
+  ParseState backtrack{state};
+  const char *start{state.GetLocation()};
+  bool isOk{true};
+  if (op == ExprOperator::AlternativeNE) {
+    static constexpr auto alternativeNE{
+        extension<LanguageFeature::AlternativeNE>("<>"_tok)};
+    isOk = alternativeNE.Parse(state).has_value();
+  } else if (op == ExprOperator::XOR) {
+    if (UserState * ustate{state.userState()}) {
+      isOk = ustate->features().IsEnabled(LanguageFeature::XOROperator);
     }
+    if (isOk) {
+      ConsumeExprOperator(state, length);
+    }
+  } else {
+    ConsumeExprOperator(state, length);
+  }
+  std::optional<Expr> right;
+  if (isOk) {
+    right = OperatorExpr{static_cast<Precedence>(PrecedenceOf(op) + 1)}.Parse(
+        state);
+  }
+  if (!right.has_value()) {
+    state = std::move(backtrack);
+    state.messages() = std::move(messages);
+    return std::nullopt;
+  }
+  if (op == ExprOperator::XOR) {
+    state.Nonstandard(CharBlock{start, state.GetLocation()},
+        LanguageFeature::XOROperator, "nonstandard usage"_en_US);
   }
+  state.messages().Restore(std::move(messages));
+  std::optional<Expr> result;
+  switch (op) {
+  case ExprOperator::Multiply:
+    result = Combine<Expr::Multiply>(left, right);
+    break;
+  case ExprOperator::Divide:
+    result = Combine<Expr::Divide>(left, right);
+    break;
+  case ExprOperator::Add:
+    result = Combine<Expr::Add>(left, right);
+    break;
+  case ExprOperator::Subtract:
+    result = Combine<Expr::Subtract>(left, right);
+    break;
+  case ExprOperator::Concat:
+    result = Combine<Expr::Concat>(left, right);
+    break;
+  case ExprOperator::LT:
+    result = Combine<Expr::LT>(left, right);
+    break;
+  case ExprOperator::LE:
+    result = Combine<Expr::LE>(left, right);
+    break;
+  case ExprOperator::EQ:
+    result = Combine<Expr::EQ>(left, right);
+    break;
+  case ExprOperator::NE:
+  case ExprOperator::AlternativeNE:
+    result = Combine<Expr::NE>(left, right);
+    break;
+  case ExprOperator::GE:
+    result = Combine<Expr::GE>(left, right);
+    break;
+  case ExprOperator::GT:
+    result = Combine<Expr::GT>(left, right);
+    break;
+  case ExprOperator::AND:
+    result = Combine<Expr::AND>(left, right);
+    break;
+  case ExprOperator::OR:
+    result = Combine<Expr::OR>(left, right);
+    break;
+  case ExprOperator::EQV:
+    result = Combine<Expr::EQV>(left, right);
+    break;
+  case ExprOperator::NEQV:
+    result = Combine<Expr::NEQV>(left, right);
+    break;
+  case ExprOperator::XOR:
+    result = Combine<Expr::XOR>(left, right);
+    break;
+  default: CRASH_NO_CASE;
+  }
+  result->source = CharBlock{start, state.GetLocation()};
   return result;
 }
 
+inline std::optional<Expr> OperatorExpr::ParseDefinedBinary(
+    ParseState &state, std::optional<Expr> &left) {
+  static constexpr OperatorExpr level5Expr{EquivPrecedence};
+  std::function<Expr(DefinedOpName &&, Expr &&)> defBinOp{
+      [&left](DefinedOpName &&op, Expr &&right) {
+        return Expr{Expr::DefinedBinary(
+            std::move(op), std::move(left).value(), std::move(right))};
+      }};
+  return attempt(sourced(applyLambda(defBinOp, definedOpName, level5Expr)))
+      .Parse(state);
+}
+
+template<> inline std::optional<Expr> Parser<Expr>::Parse(ParseState &state) {
+  static constexpr OperatorExpr expr{OperatorExpr::DefinedBinaryPrecedence};
+  return expr.Parse(state);
+}
+
 // R1028 specification-expr -> scalar-int-expr
 TYPE_PARSER(construct<SpecificationExpr>(scalarIntExpr))
 
@@ -15,8 +15,11 @@
 #include "instrumented-parser.h"
 #include "message.h"
 #include "provenance.h"
+#include <algorithm>
 #include <map>
 #include <ostream>
+#include <string>
+#include <vector>
 
 namespace Fortran::parser {
 
@@ -80,4 +83,72 @@ void ParsingLog::Dump(std::ostream &o, const CookedSource &cooked) const {
     }
   }
 }
+
+// The tags of all profiled productions, which outlive any one profile.
+static std::vector<MessageFixedText> profiledTags;
+
+// Tags are looked up by the addresses of their texts; a text that
+// appears at more than one address gets the number of its first.
+int ParsingProfile::TagId(const MessageFixedText &tag, int &cache) {
+  const char *text{tag.text().begin()};
+  if (cache >= 0 && profiledTags[cache].text().begin() == text) {
+    return cache;
+  }
+  static std::map<const char *, int> idOfText;
+  auto iter{idOfText.find(text)};
+  if (iter == idOfText.end()) {
+    auto same{std::find_if(profiledTags.begin(), profiledTags.end(),
+        [&](const MessageFixedText &x) { return x.text() == tag.text(); })};
+    int id{static_cast<int>(same - profiledTags.begin())};
+    if (same == profiledTags.end()) {
+      profiledTags.push_back(tag);
+    }
+    iter = idOfText.emplace(text, id).first;
+  }
+  cache = iter->second;
+  return cache;
+}
+
+void ParsingProfile::End(
+    int tagId, const Attempt &attempt, bool pass, const ParseState &state) {
+  std::chrono::nanoseconds elapsed{Clock::now() - attempt.start};
+  if (static_cast<std::size_t>(tagId) >= perTag_.size()) {
+    perTag_.resize(profiledTags.size());
+  }
+  Counters &counters{perTag_[tagId]};
+  ++counters.attempts;
+  if (pass) {
+    ++counters.successes;
+  } else if (state.GetLocation() > attempt.at) {
+    counters.backtracked += state.GetLocation() - attempt.at;
+  }
+  counters.inclusive += elapsed;
+  counters.exclusive += elapsed - nested_;
+  nested_ = attempt.enclosingNested + elapsed;
+}
+
+void ParsingProfile::clear() {
+  perTag_.clear();
+  nested_ = nested_.zero();
+}
+
+void ParsingProfile::Dump(std::ostream &o) const {
+  std::vector<std::size_t> order;
+  for (std::size_t j{0}; j < perTag_.size(); ++j) {
+    if (perTag_[j].attempts > 0) {
+      order.push_back(j);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+    return perTag_[x].exclusive > perTag_[y].exclusive;
+  });
+  o << "self(us) total(us) attempts successes backtracked production\n";
+  for (std::size_t j : order) {
+    const Counters &counters{perTag_[j]};
+    o << counters.exclusive.count() / 1000 << ' '
+      << counters.inclusive.count() / 1000 << ' ' << counters.attempts << ' '
+      << counters.successes << ' ' << counters.backtracked << ' '
+      << profiledTags[j].text().ToString() << '\n';
+  }
+}
 }
@@ -19,9 +19,12 @@
 #include "parse-state.h"
 #include "provenance.h"
 #include "user-state.h"
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <map>
 #include <ostream>
+#include <vector>
 
 namespace Fortran::parser {
 
@@ -50,6 +53,45 @@ private:
   std::map<std::size_t, LogForPosition> perPos_;
 };
 
+// A lightweight alternative to ParsingLog for tuning the grammar on
+// large inputs: only flat counters are kept for each distinct tag.
+// Times are measured both inclusively and exclusively of the time spent
+// in nested instrumented parsers; "backtracked" counts the characters
+// consumed by failed attempts.
+class ParsingProfile {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Tags are numbered as they are first seen.  Each instrumented parser
+  // type caches its tag's number, which is rechecked against the tag in
+  // case distinct productions share a parser type.
+  static int TagId(const MessageFixedText &, int &cache);
+
+  struct Attempt {
+    const char *at;
+    Clock::time_point start;
+    std::chrono::nanoseconds enclosingNested;
+  };
+
+  Attempt Begin(const char *at) {
+    Attempt attempt{at, Clock::now(), nested_};
+    nested_ = nested_.zero();
+    return attempt;
+  }
+  void End(int tagId, const Attempt &, bool pass, const ParseState &);
+
+  void clear();
+  void Dump(std::ostream &) const;  // hottest productions first
+
+private:
+  struct Counters {
+    std::uint64_t attempts{0}, successes{0}, backtracked{0};
+    std::chrono::nanoseconds inclusive{0}, exclusive{0};
+  };
+  std::vector<Counters> perTag_;
+  std::chrono::nanoseconds nested_{0};
+};
+
 template<typename PA> class InstrumentedParser {
 public:
   using resultType = typename PA::resultType;
@@ -58,22 +100,36 @@ public:
     : tag_{tag}, parser_{parser} {}
   std::optional<resultType> Parse(ParseState &state) const {
     if (UserState * ustate{state.userState()}) {
-      if (ParsingLog * log{ustate->log()}) {
-        const char *at{state.GetLocation()};
-        if (log->Fails(at, tag_, state)) {
-          return std::nullopt;
-        }
-        Messages messages{std::move(state.messages())};
-        std::optional<resultType> result{parser_.Parse(state)};
-        log->Note(at, tag_, result.has_value(), state);
-        state.messages().Restore(std::move(messages));
+      if (ParsingProfile * profile{ustate->profile()}) {
+        int tagId{ParsingProfile::TagId(tag_, tagId_)};
+        auto attempt{profile->Begin(state.GetLocation())};
+        std::optional<resultType> result{ParseLogged(*ustate, state)};
+        profile->End(tagId, attempt, result.has_value(), state);
         return result;
       }
+      return ParseLogged(*ustate, state);
     }
     return parser_.Parse(state);
   }
 
 private:
+  std::optional<resultType> ParseLogged(
+      UserState &ustate, ParseState &state) const {
+    if (ParsingLog * log{ustate.log()}) {
+      const char *at{state.GetLocation()};
+      if (log->Fails(at, tag_, state)) {
+        return std::nullopt;
+      }
+      Messages messages{std::move(state.messages())};
+      std::optional<resultType> result{parser_.Parse(state)};
+      log->Note(at, tag_, result.has_value(), state);
+      state.messages().Restore(std::move(messages));
+      return result;
+    }
+    return parser_.Parse(state);
+  }
+
+  static inline int tagId_{-1};
   const MessageFixedText tag_;
   const PA parser_;
 };
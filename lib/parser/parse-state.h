@@ -41,6 +41,9 @@ public:
   // TODO: Add a constructor for parsing a normalized module file.
   ParseState(const CookedSource &cooked)
     : p_{&cooked.data().front()}, limit_{&cooked.data().back() + 1} {}
+  // For parsing a range of whole lines within a cooked source
+  explicit ParseState(CharBlock range)
+    : p_{range.begin()}, limit_{range.end()} {}
   ParseState(const ParseState &that)
     : p_{that.p_}, limit_{that.limit_}, context_{that.context_},
       userState_{that.userState_}, inFixedForm_{that.inFixedForm_},
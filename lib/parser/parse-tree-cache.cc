@@ -0,0 +1,465 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "parse-tree-cache.h"
+#include "binary-stream.h"
+#include "parse-tree.h"
+#include "provenance.h"
+#include "../common/idioms.h"
+#include "../common/indirection.h"
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <list>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// A saved parse tree is laid out as follows:
+//   the magic string;
+//   the format stamp, the caller's key, and the CookedSource;
+//   the parse tree, in the order of a Walk() of it;
+//   a hash of everything before it, in eight bytes.
+// A parse tree node is saved as its components: the std::tuple<>,
+// std::variant<>, or wrapped value of a class with a trait, the members of
+// a class with a custom Walk(), and the CharBlock source of either.  The
+// values of std::variant<> are preceded by their indices, std::optional<>
+// by a flag, and std::list<> by its length.  A CharBlock is saved as
+// its offset in the cooked character stream (plus one, so that zero
+// denotes a null CharBlock) and its length.  The analyses of semantics
+// (symbols and typed expressions) are not saved.
+
+namespace Fortran::parser {
+
+static const char magic[]{"f18 parse tree\n"};
+static constexpr std::size_t magicBytes{sizeof magic - 1};
+static constexpr std::size_t hashBytes{8};
+
+// Saved parse trees are specific to the parse tree classes and grammar
+// that wrote them.  The build defines PARSE_TREE_SOURCE_HASH as a hash of
+// the headers that define the parse tree, grammar.h, and this file; bump
+// formatVersion anyway when the way that this file saves a parse tree
+// changes, for builds without the hash.
+static constexpr int formatVersion{2};
+#ifndef PARSE_TREE_SOURCE_HASH
+#define PARSE_TREE_SOURCE_HASH ""
+#endif
+static const std::string formatStamp{
+    std::to_string(formatVersion) + " " PARSE_TREE_SOURCE_HASH};
+
+// The members of each class with a custom Walk(), in the order that its
+// constructor takes them.
+template<auto... MEMBERS> struct MemberList {};
+template<typename A> struct SavedMembers;
+#define SAVED_MEMBERS(classname, ...) \
+  template<> struct SavedMembers<classname> { \
+    using type = MemberList<__VA_ARGS__>; \
+  }
+SAVED_MEMBERS(AcSpec, &AcSpec::type, &AcSpec::values);
+SAVED_MEMBERS(ArrayElement, &ArrayElement::base, &ArrayElement::subscripts);
+SAVED_MEMBERS(CharSelector::LengthAndKind,
+    &CharSelector::LengthAndKind::length, &CharSelector::LengthAndKind::kind);
+SAVED_MEMBERS(CaseValueRange::Range, &CaseValueRange::Range::lower,
+    &CaseValueRange::Range::upper);
+SAVED_MEMBERS(CoindexedNamedObject, &CoindexedNamedObject::base,
+    &CoindexedNamedObject::imageSelector);
+SAVED_MEMBERS(DeclarationTypeSpec::Class, &DeclarationTypeSpec::Class::derived);
+SAVED_MEMBERS(DeclarationTypeSpec::Type, &DeclarationTypeSpec::Type::derived);
+SAVED_MEMBERS(ImportStmt, &ImportStmt::kind, &ImportStmt::names);
+SAVED_MEMBERS(
+    IntrinsicTypeSpec::Character, &IntrinsicTypeSpec::Character::selector);
+SAVED_MEMBERS(IntrinsicTypeSpec::Complex, &IntrinsicTypeSpec::Complex::kind);
+SAVED_MEMBERS(IntrinsicTypeSpec::Logical, &IntrinsicTypeSpec::Logical::kind);
+SAVED_MEMBERS(IntrinsicTypeSpec::Real, &IntrinsicTypeSpec::Real::kind);
+SAVED_MEMBERS(
+    PartRef, &PartRef::name, &PartRef::subscripts, &PartRef::imageSelector);
+SAVED_MEMBERS(ReadStmt, &ReadStmt::iounit, &ReadStmt::format,
+    &ReadStmt::controls, &ReadStmt::items);
+SAVED_MEMBERS(
+    RealLiteralConstant, &RealLiteralConstant::real, &RealLiteralConstant::kind);
+SAVED_MEMBERS(StructureComponent, &StructureComponent::base,
+    &StructureComponent::component);
+SAVED_MEMBERS(TypeBoundProcedureStmt::WithInterface,
+    &TypeBoundProcedureStmt::WithInterface::interfaceName,
+    &TypeBoundProcedureStmt::WithInterface::attributes,
+    &TypeBoundProcedureStmt::WithInterface::bindingNames);
+SAVED_MEMBERS(TypeBoundProcedureStmt::WithoutInterface,
+    &TypeBoundProcedureStmt::WithoutInterface::attributes,
+    &TypeBoundProcedureStmt::WithoutInterface::declarations);
+SAVED_MEMBERS(WriteStmt, &WriteStmt::iounit, &WriteStmt::format,
+    &WriteStmt::controls, &WriteStmt::items);
+SAVED_MEMBERS(format::ControlEditDesc, &format::ControlEditDesc::kind,
+    &format::ControlEditDesc::count);
+SAVED_MEMBERS(format::DerivedTypeDataEditDesc,
+    &format::DerivedTypeDataEditDesc::type,
+    &format::DerivedTypeDataEditDesc::parameters);
+SAVED_MEMBERS(format::FormatItem, &format::FormatItem::repeatCount,
+    &format::FormatItem::u);
+SAVED_MEMBERS(format::FormatSpecification,
+    &format::FormatSpecification::items,
+    &format::FormatSpecification::unlimitedItems);
+SAVED_MEMBERS(format::IntrinsicTypeDataEditDesc,
+    &format::IntrinsicTypeDataEditDesc::kind,
+    &format::IntrinsicTypeDataEditDesc::width,
+    &format::IntrinsicTypeDataEditDesc::digits,
+    &format::IntrinsicTypeDataEditDesc::exponentWidth);
+SAVED_MEMBERS(OmpLinearClause::WithModifier,
+    &OmpLinearClause::WithModifier::modifier,
+    &OmpLinearClause::WithModifier::names,
+    &OmpLinearClause::WithModifier::step);
+SAVED_MEMBERS(OmpLinearClause::WithoutModifier,
+    &OmpLinearClause::WithoutModifier::names,
+    &OmpLinearClause::WithoutModifier::step);
+SAVED_MEMBERS(OpenMPDeclareTargetConstruct::WithClause,
+    &OpenMPDeclareTargetConstruct::WithClause::maptype,
+    &OpenMPDeclareTargetConstruct::WithClause::names);
+SAVED_MEMBERS(OpenMPDeclareTargetConstruct::WithExtendedList,
+    &OpenMPDeclareTargetConstruct::WithExtendedList::names);
+#undef SAVED_MEMBERS
+template<typename T> struct SavedMembers<LoopBounds<T>> {
+  using type = MemberList<&LoopBounds<T>::name, &LoopBounds<T>::lower,
+      &LoopBounds<T>::upper, &LoopBounds<T>::step>;
+};
+
+template<typename A, typename C> A MemberTypeOf(A C::*);
+template<auto MEMBER> using MemberType = decltype(MemberTypeOf(MEMBER));
+
+template<typename A, typename = void> constexpr bool HasSource{false};
+template<typename A>
+constexpr bool HasSource<A, std::void_t<decltype(A::source)>>{
+    std::is_same_v<decltype(A::source), CharBlock>};
+
+class ParseTreeSaver {
+public:
+  ParseTreeSaver(BinaryWriter &writer, const CookedSource &cooked)
+    : writer_{writer}, cooked_{cooked.data()} {}
+
+  // False when some CharBlock lies outside the cooked character stream.
+  bool ok() const { return ok_; }
+
+  template<typename A> void Save(const A &x) {
+    if constexpr (std::is_same_v<A, bool>) {
+      writer_.Put(x);
+    } else if constexpr (std::is_enum_v<A>) {
+      writer_.Put(static_cast<std::uint64_t>(x));
+    } else if constexpr (std::is_integral_v<A> && std::is_signed_v<A>) {
+      writer_.PutSigned(x);
+    } else if constexpr (std::is_integral_v<A>) {
+      writer_.Put(x);
+    } else if constexpr (std::is_same_v<A, std::string>) {
+      writer_.Put(x);
+    } else if constexpr (std::is_same_v<A, const char *>) {
+      Save(x, 0);
+    } else if constexpr (std::is_same_v<A, CharBlock>) {
+      Save(x.begin(), x.size());
+    } else if constexpr (EmptyTrait<A>) {
+    } else if constexpr (TupleTrait<A>) {
+      Save(x.t);
+      SaveSource(x);
+    } else if constexpr (UnionTrait<A>) {
+      Save(x.u);
+      SaveSource(x);
+    } else if constexpr (WrapperTrait<A>) {
+      Save(x.v);
+      SaveSource(x);
+    } else {
+      SaveMembers(x, typename SavedMembers<A>::type{});
+    }
+  }
+  template<typename A> void Save(const std::optional<A> &x) {
+    writer_.Put(x.has_value());
+    if (x.has_value()) {
+      Save(*x);
+    }
+  }
+  template<typename A> void Save(const std::list<A> &x) {
+    writer_.Put(x.size());
+    for (const A &y : x) {
+      Save(y);
+    }
+  }
+  template<typename... A> void Save(const std::tuple<A...> &x) {
+    std::apply([&](const A &... y) { (Save(y), ...); }, x);
+  }
+  template<typename... A> void Save(const std::variant<A...> &x) {
+    writer_.Put(x.index());
+    std::visit([&](const auto &y) { Save(y); }, x);
+  }
+  template<typename A, bool COPY>
+  void Save(const common::Indirection<A, COPY> &x) {
+    Save(*x);
+  }
+  template<typename A> void Save(const Scalar<A> &x) { Save(x.thing); }
+  template<typename A> void Save(const Constant<A> &x) { Save(x.thing); }
+  template<typename A> void Save(const Integer<A> &x) { Save(x.thing); }
+  template<typename A> void Save(const Logical<A> &x) { Save(x.thing); }
+  template<typename A> void Save(const DefaultChar<A> &x) { Save(x.thing); }
+  template<typename A> void Save(const Statement<A> &x) {
+    Save(x.label);
+    Save(x.statement);
+    Save(x.source);
+  }
+  void Save(const Name &x) { Save(x.source); }
+  void Save(const RealLiteralConstant::Real &x) { Save(x.source); }
+  void Save(const Suffix &x) {
+    Save(x.binding);
+    Save(x.resultName);
+  }
+  void Save(const UseStmt &x) {
+    Save(x.nature);
+    Save(x.moduleName);
+    Save(x.u);
+  }
+
+private:
+  void Save(const char *p, std::size_t bytes) {
+    if (p == nullptr) {
+      writer_.Put(std::uint64_t{0});
+    } else {
+      if (p < cooked_.data() || p + bytes > cooked_.data() + cooked_.size()) {
+        ok_ = false;
+      }
+      writer_.Put(static_cast<std::uint64_t>(p - cooked_.data() + 1));
+    }
+    writer_.Put(bytes);
+  }
+  template<typename A> void SaveSource(const A &x) {
+    if constexpr (HasSource<A>) {
+      Save(x.source);
+    }
+  }
+  template<typename A, auto... MEMBERS>
+  void SaveMembers(const A &x, MemberList<MEMBERS...>) {
+    (Save(x.*MEMBERS), ...);
+  }
+
+  BinaryWriter &writer_;
+  const std::string &cooked_;
+  bool ok_{true};
+};
+
+template<typename A> struct Tag {};
+
+class ParseTreeLoader {
+public:
+  ParseTreeLoader(BinaryReader &reader, const CookedSource &cooked)
+    : reader_{reader}, cooked_{cooked.data()} {}
+
+  template<typename A> A Load(Tag<A>) {
+    if constexpr (std::is_same_v<A, bool>) {
+      return reader_.Get() != 0;
+    } else if constexpr (std::is_enum_v<A>) {
+      return static_cast<A>(reader_.Get());
+    } else if constexpr (std::is_integral_v<A> && std::is_signed_v<A>) {
+      return static_cast<A>(reader_.GetSigned());
+    } else if constexpr (std::is_integral_v<A>) {
+      return static_cast<A>(reader_.Get());
+    } else if constexpr (std::is_same_v<A, std::string>) {
+      return reader_.GetString();
+    } else if constexpr (std::is_same_v<A, const char *>) {
+      return LoadCharBlock().begin();
+    } else if constexpr (std::is_same_v<A, CharBlock>) {
+      return LoadCharBlock();
+    } else if constexpr (EmptyTrait<A>) {
+      return A{};
+    } else if constexpr (TupleTrait<A>) {
+      return LoadSource(A{Load(Tag<decltype(A::t)>{})});
+    } else if constexpr (UnionTrait<A>) {
+      return LoadSource(A{Load(Tag<decltype(A::u)>{})});
+    } else if constexpr (WrapperTrait<A>) {
+      return LoadSource(A{Load(Tag<decltype(A::v)>{})});
+    } else {
+      return LoadMembers<A>(typename SavedMembers<A>::type{});
+    }
+  }
+  template<typename A> std::optional<A> Load(Tag<std::optional<A>>) {
+    if (reader_.Get() != 0) {
+      return Load(Tag<A>{});
+    } else {
+      return std::nullopt;
+    }
+  }
+  template<typename A> std::list<A> Load(Tag<std::list<A>>) {
+    std::list<A> result;
+    for (std::size_t n{reader_.GetSize()}; n > 0; --n) {
+      result.emplace_back(Load(Tag<A>{}));
+    }
+    return result;
+  }
+  template<typename... A> std::tuple<A...> Load(Tag<std::tuple<A...>>) {
+    return std::tuple<A...>{Load(Tag<A>{})...};  // in order
+  }
+  template<typename... A> std::variant<A...> Load(Tag<std::variant<A...>>) {
+    return LoadAlternative<0, std::variant<A...>>(reader_.Get());
+  }
+  template<typename A, bool COPY>
+  common::Indirection<A, COPY> Load(Tag<common::Indirection<A, COPY>>) {
+    A *p{new A(Load(Tag<A>{}))};
+    return {std::move(p)};
+  }
+  template<typename A> Scalar<A> Load(Tag<Scalar<A>>) {
+    return Scalar<A>{Load(Tag<A>{})};
+  }
+  template<typename A> Constant<A> Load(Tag<Constant<A>>) {
+    return Constant<A>{Load(Tag<A>{})};
+  }
+  template<typename A> Integer<A> Load(Tag<Integer<A>>) {
+    return Integer<A>{Load(Tag<A>{})};
+  }
+  template<typename A> Logical<A> Load(Tag<Logical<A>>) {
+    return Logical<A>{Load(Tag<A>{})};
+  }
+  template<typename A> DefaultChar<A> Load(Tag<DefaultChar<A>>) {
+    return DefaultChar<A>{Load(Tag<A>{})};
+  }
+  template<typename A> Statement<A> Load(Tag<Statement<A>>) {
+    std::optional<long> label;
+    if (auto saved{Load(Tag<std::optional<Label>>{})}) {
+      label = static_cast<long>(*saved);
+    }
+    Statement<A> result{std::move(label), Load(Tag<A>{})};
+    result.source = LoadCharBlock();
+    return result;
+  }
+  Name Load(Tag<Name>) {
+    Name result;
+    result.source = LoadCharBlock();
+    return result;
+  }
+  RealLiteralConstant::Real Load(Tag<RealLiteralConstant::Real>) {
+    RealLiteralConstant::Real result;
+    result.source = LoadCharBlock();
+    return result;
+  }
+  Suffix Load(Tag<Suffix>) {
+    auto binding{Load(Tag<std::optional<LanguageBindingSpec>>{})};
+    auto resultName{Load(Tag<std::optional<Name>>{})};
+    if (resultName.has_value()) {
+      return Suffix{std::move(*resultName), std::move(binding)};
+    }
+    CHECK(binding.has_value());
+    return Suffix{std::move(*binding), std::nullopt};
+  }
+  UseStmt Load(Tag<UseStmt>) {
+    auto nature{Load(Tag<std::optional<UseStmt::ModuleNature>>{})};
+    auto moduleName{Load(Tag<Name>{})};
+    return std::visit(
+        [&](auto &&list) {
+          return UseStmt{
+              std::move(nature), std::move(moduleName), std::move(list)};
+        },
+        Load(Tag<decltype(UseStmt::u)>{}));
+  }
+
+private:
+  CharBlock LoadCharBlock() {
+    std::size_t offset{reader_.Get()};
+    std::size_t bytes{reader_.Get()};
+    if (offset == 0) {
+      return {};
+    }
+    if (offset - 1 > cooked_.size() || bytes > cooked_.size() - (offset - 1)) {
+      reader_.Fail();
+      return {};
+    }
+    return {cooked_.data() + offset - 1, bytes};
+  }
+  template<typename A> A LoadSource(A &&x) {
+    if constexpr (HasSource<A>) {
+      x.source = LoadCharBlock();
+    }
+    return std::move(x);
+  }
+  template<typename A, auto... MEMBERS> A LoadMembers(MemberList<MEMBERS...>) {
+    return A{Load(Tag<MemberType<MEMBERS>>{})...};  // in order
+  }
+  template<std::size_t J, typename VARIANT>
+  VARIANT LoadAlternative(std::size_t which) {
+    if constexpr (J + 1 < std::variant_size_v<VARIANT>) {
+      if (which != J) {
+        return LoadAlternative<J + 1, VARIANT>(which);
+      }
+    } else if (which != J) {
+      reader_.Fail();
+      return LoadAlternative<0, VARIANT>(0);
+    }
+    using Alternative = std::variant_alternative_t<J, VARIANT>;
+    return VARIANT{std::in_place_index<J>, Load(Tag<Alternative>{})};
+  }
+
+  BinaryReader &reader_;
+  const std::string &cooked_;
+};
+
+static void PutHash(std::string &buffer, std::uint64_t hash) {
+  for (std::size_t j{0}; j < hashBytes; ++j, hash >>= 8) {
+    buffer += static_cast<char>(hash & 0xff);
+  }
+}
+
+static std::uint64_t GetHash(const char *p) {
+  std::uint64_t hash{0};
+  for (std::size_t j{hashBytes}; j-- > 0;) {
+    hash = (hash << 8) | static_cast<unsigned char>(p[j]);
+  }
+  return hash;
+}
+
+bool SaveParseTree(std::ostream &out, const std::string &key,
+    const Program &program, const CookedSource &cooked) {
+  std::string buffer{magic};
+  BinaryWriter writer{buffer};
+  writer.Put(formatStamp);
+  writer.Put(key);
+  cooked.Save(writer);
+  ParseTreeSaver saver{writer, cooked};
+  saver.Save(program);
+  if (!saver.ok()) {
+    return false;
+  }
+  PutHash(buffer, HashBytes(buffer.data(), buffer.size()));
+  out.write(buffer.data(), buffer.size());
+  return out.good();
+}
+
+std::optional<Program> LoadParseTree(
+    std::istream &in, const std::string &key, CookedSource &cooked) {
+  std::string buffer{
+      std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  if (buffer.size() < magicBytes + hashBytes ||
+      std::memcmp(buffer.data(), magic, magicBytes) != 0) {
+    return std::nullopt;
+  }
+  std::size_t bytes{buffer.size() - hashBytes};
+  if (HashBytes(buffer.data(), bytes) != GetHash(buffer.data() + bytes)) {
+    return std::nullopt;
+  }
+  BinaryReader reader{buffer.data() + magicBytes, buffer.data() + bytes};
+  if (reader.GetString() != formatStamp || reader.GetString() != key ||
+      !cooked.Load(reader)) {
+    return std::nullopt;
+  }
+  ParseTreeLoader loader{reader, cooked};
+  std::optional<Program> result{loader.Load(Tag<Program>{})};
+  if (!reader.ok() || !reader.AtEnd()) {
+    return std::nullopt;
+  }
+  return result;
+}
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FORTRAN_PARSER_PARSE_TREE_CACHE_H_
+#define FORTRAN_PARSER_PARSE_TREE_CACHE_H_
+
+// Saves the results of prescanning and parsing a program in a compact
+// binary form and reloads them, so that tools can skip both steps for
+// unchanged source files.  A saved parse tree is accompanied by the
+// cooked character stream into which its CharBlocks point, together with
+// the provenance mappings and source origins needed to emit messages.
+//
+// A saved parse tree is valid only as long as every source file that
+// contributed to it is unchanged; their contents are hashed when it is
+// saved and checked when it is reloaded.  Anything else that affects
+// prescanning and parsing, such as the predefined macros, the source form,
+// and the enabled language features, must be rendered by the caller into
+// a key that must also match.  Saved parse trees are specific to the
+// build of the compiler that wrote them.
+
+#include "parse-tree.h"
+#include "provenance.h"
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+namespace Fortran::parser {
+
+// Returns false when the parse tree cannot be saved.
+bool SaveParseTree(std::ostream &, const std::string &key, const Program &,
+    const CookedSource &);
+
+// The AllSources instance of the CookedSource must not yet have any
+// sources of its own.  The result is std::nullopt when the saved parse
+// tree was damaged, was saved with another key or by another build, or
+// is stale.
+std::optional<Program> LoadParseTree(
+    std::istream &, const std::string &key, CookedSource &);
+}
+#endif  // FORTRAN_PARSER_PARSE_TREE_CACHE_H_
@@ -0,0 +1,121 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "parse-tree-layout.h"
+#include "parse-tree-visitor.h"
+#include "parse-tree.h"
+#include "../common/indirection.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace Fortran::parser {
+
+// Moves the dynamically allocated children of each node into fresh storage
+// as the node is visited, before the traversal descends into them.  Only
+// nodes for which Walk() calls Pre() are seen, so allocations beneath the
+// other wrappers (std::optional<>, std::list<>, common::Indirection<>,
+// Scalar<>, &c.) are followed down to the next such node.
+//
+// The old storage is retained until the whole tree has been laid out anew,
+// since an allocator would otherwise hand a just-released block right back
+// for the next new node.  Moving nodes out of a std::list<> by splicing it
+// into a graveyard, and keeping old Indirections in vectors, avoid further
+// small allocations interleaved with the new nodes.
+class ParseTreeRelayout {
+public:
+  template<typename A> std::enable_if_t<!WrapperTrait<A>, bool> Pre(A &) {
+    return true;
+  }
+  template<typename A> std::enable_if_t<WrapperTrait<A>, bool> Pre(A &x) {
+    Relocate(x.v);
+    return true;
+  }
+  template<typename... A> bool Pre(std::tuple<A...> &x) {
+    ForEachInTuple(x, [&](auto &y) { Relocate(y); });
+    return true;
+  }
+  template<typename... A> bool Pre(std::variant<A...> &x) {
+    std::visit([&](auto &y) { Relocate(y); }, x);
+    return true;
+  }
+  template<typename T> bool Pre(Statement<T> &x) {
+    Relocate(x.statement);
+    return true;
+  }
+  template<typename A> void Post(A &) {}
+
+private:
+  struct GraveBase {
+    virtual ~GraveBase() {}
+  };
+  template<typename T> struct Grave : public GraveBase {
+    std::list<T> listNodes;
+    std::vector<common::Indirection<T>> indirections;
+  };
+  template<typename T> struct GraveKey {
+    static constexpr char key{'\0'};
+  };
+
+  template<typename T> Grave<T> &GraveFor() {
+    auto &grave{graves_[&GraveKey<T>::key]};
+    if (!grave) {
+      grave = std::make_unique<Grave<T>>();
+    }
+    return *static_cast<Grave<T> *>(grave.get());
+  }
+
+  // Values that Walk() calls Pre() upon are handled when it does.
+  template<typename A> void Relocate(A &) {}
+  template<typename T> void Relocate(std::optional<T> &x) {
+    if (x.has_value()) {
+      Relocate(*x);
+    }
+  }
+  template<typename T> void Relocate(std::list<T> &x) {
+    std::list<T> old;
+    old.swap(x);
+    for (T &y : old) {
+      x.emplace_back(std::move(y));
+    }
+    GraveFor<T>().listNodes.splice(GraveFor<T>().listNodes.end(), old);
+    for (T &y : x) {
+      Relocate(y);
+    }
+  }
+  template<typename T> void Relocate(common::Indirection<T> &x) {
+    common::Indirection<T> fresh{std::move(*x)};
+    x = std::move(fresh);  // swaps; fresh now owns the old storage
+    GraveFor<T>().indirections.emplace_back(std::move(fresh));
+    Relocate(*x);
+  }
+  template<typename T> void Relocate(Scalar<T> &x) { Relocate(x.thing); }
+  template<typename T> void Relocate(Constant<T> &x) { Relocate(x.thing); }
+  template<typename T> void Relocate(Integer<T> &x) { Relocate(x.thing); }
+  template<typename T> void Relocate(Logical<T> &x) { Relocate(x.thing); }
+  template<typename T> void Relocate(DefaultChar<T> &x) { Relocate(x.thing); }
+
+  std::map<const char *, std::unique_ptr<GraveBase>> graves_;
+};
+
+void RelayoutParseTree(Program &program) {
+  ParseTreeRelayout relayout;
+  Walk(program, relayout);
+}
+}
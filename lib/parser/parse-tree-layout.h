@@ -0,0 +1,34 @@
+// Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FORTRAN_PARSER_PARSE_TREE_LAYOUT_H_
+#define FORTRAN_PARSER_PARSE_TREE_LAYOUT_H_
+
+// The parser builds each node of the parse tree after its children and
+// among the debris of failed alternatives, so the nodes that a Walk()
+// visits in succession are scattered in memory.  RelayoutParseTree()
+// moves the dynamically allocated nodes of a parse tree (those owned by
+// std::list<> and common::Indirection<>) into fresh storage, allocated
+// in the order of a traversal, so that later traversals have much better
+// locality of reference.  The types of the nodes and the visitor interface
+// are unchanged.  It must be applied before anything retains a pointer to
+// a node of the tree, i.e. before semantic analysis.
+
+namespace Fortran::parser {
+
+struct Program;
+
+void RelayoutParseTree(Program &);
+}
+#endif  // FORTRAN_PARSER_PARSE_TREE_LAYOUT_H_
@@ -16,11 +16,17 @@
 #define FORTRAN_PARSER_PARSE_TREE_VISITOR_H_
 
 #include "parse-tree.h"
+#include "../common/template.h"
+#include <array>
 #include <cstddef>
+#include <list>
+#include <map>
 #include <optional>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 /// Parse tree visitor
 /// Call Walk(x, visitor) to visit x and, by default, each node under x.
@@ -30,16 +36,337 @@
 /// visited if it returns false.
 ///
 /// visitor.Post(x) is called after visiting x.
+///
+/// A visitor may declare the node types in which it is interested so that
+/// subtrees that cannot contain them are skipped; see InterestingTypes below.
 
 namespace Fortran::parser {
 
+// Subtree pruning for visitors with declared interests
+// A visitor or mutator may declare the parse tree node types for which
+// its Pre() or Post() member functions do more than the defaults do:
+//   using InterestingTypes = std::tuple<DoConstruct, Name>;
+// Walk() then skips each subtree that cannot contain a node of any of
+// those types, so Pre() and Post() are not called for the nodes within
+// it.  The visitor must tolerate Pre() and Post() being skipped for the
+// nodes of other types, including the std::tuple<>, std::variant<>, &c.
+// containers and the Statement<> wrappers, whenever they cannot contain
+// an interesting node.
+//
+// Whether a node of type A can contain a node of an interesting type
+// depends only on the types.  As the parse tree's types are recursive,
+// it is determined once for each pair of (interests, A) by a search of the
+// graph of the types that Walk() can reach from A, and then remembered.
+
+// WalkChildren<A>::type is a std::tuple<> of the types of the values that
+// Walk() traverses directly within a value of type A, or void when they
+// are not known, in which case a value of type A is assumed to be able to
+// contain anything.  These must be kept consistent with the Walk()
+// overloads below.
+template<typename A, typename = void> struct WalkChildren {
+  using type = void;
+};
+template<typename A>
+struct WalkChildren<A,
+    std::enable_if_t<!std::is_class_v<A> || std::is_same_v<std::string, A> ||
+        std::is_same_v<CharBlock, A> || EmptyTrait<A>>> {
+  using type = std::tuple<>;
+};
+template<typename A> struct WalkChildren<A, std::enable_if_t<TupleTrait<A>>> {
+  using type = std::tuple<decltype(A::t)>;
+};
+template<typename A> struct WalkChildren<A, std::enable_if_t<UnionTrait<A>>> {
+  using type = std::tuple<decltype(A::u)>;
+};
+template<typename A>
+struct WalkChildren<A, std::enable_if_t<WrapperTrait<A>>> {
+  using type = std::tuple<decltype(A::v)>;
+};
+template<typename T> struct WalkChildren<std::optional<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<std::list<T>> {
+  using type = std::tuple<T>;
+};
+template<typename... A> struct WalkChildren<std::tuple<A...>> {
+  using type = std::tuple<A...>;
+};
+template<typename... A> struct WalkChildren<std::variant<A...>> {
+  using type = std::tuple<A...>;
+};
+template<typename A, typename B> struct WalkChildren<std::pair<A, B>> {
+  using type = std::tuple<A, B>;
+};
+template<typename T> struct WalkChildren<common::Indirection<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<Scalar<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<Constant<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<Integer<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<Logical<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<DefaultChar<T>> {
+  using type = std::tuple<T>;
+};
+template<typename T> struct WalkChildren<Statement<T>> {
+  using type = std::tuple<T>;  // N.B. the label is not traversed
+};
+template<> struct WalkChildren<Name> { using type = std::tuple<>; };
+template<> struct WalkChildren<AcSpec> {
+  using type = std::tuple<decltype(AcSpec::type), decltype(AcSpec::values)>;
+};
+template<> struct WalkChildren<ArrayElement> {
+  using type = std::tuple<decltype(ArrayElement::base),
+      decltype(ArrayElement::subscripts)>;
+};
+template<> struct WalkChildren<CharSelector::LengthAndKind> {
+  using type = std::tuple<decltype(CharSelector::LengthAndKind::length),
+      decltype(CharSelector::LengthAndKind::kind)>;
+};
+template<> struct WalkChildren<CaseValueRange::Range> {
+  using type = std::tuple<decltype(CaseValueRange::Range::lower),
+      decltype(CaseValueRange::Range::upper)>;
+};
+template<> struct WalkChildren<CoindexedNamedObject> {
+  using type = std::tuple<decltype(CoindexedNamedObject::base),
+      decltype(CoindexedNamedObject::imageSelector)>;
+};
+template<> struct WalkChildren<DeclarationTypeSpec::Class> {
+  using type = std::tuple<decltype(DeclarationTypeSpec::Class::derived)>;
+};
+template<> struct WalkChildren<DeclarationTypeSpec::Type> {
+  using type = std::tuple<decltype(DeclarationTypeSpec::Type::derived)>;
+};
+template<> struct WalkChildren<ImportStmt> {
+  using type = std::tuple<decltype(ImportStmt::names)>;
+};
+template<> struct WalkChildren<IntrinsicTypeSpec::Character> {
+  using type = std::tuple<decltype(IntrinsicTypeSpec::Character::selector)>;
+};
+template<> struct WalkChildren<IntrinsicTypeSpec::Complex> {
+  using type = std::tuple<decltype(IntrinsicTypeSpec::Complex::kind)>;
+};
+template<> struct WalkChildren<IntrinsicTypeSpec::Logical> {
+  using type = std::tuple<decltype(IntrinsicTypeSpec::Logical::kind)>;
+};
+template<> struct WalkChildren<IntrinsicTypeSpec::Real> {
+  using type = std::tuple<decltype(IntrinsicTypeSpec::Real::kind)>;
+};
+template<typename T> struct WalkChildren<LoopBounds<T>> {
+  using type = std::tuple<decltype(LoopBounds<T>::name),
+      decltype(LoopBounds<T>::lower), decltype(LoopBounds<T>::upper),
+      decltype(LoopBounds<T>::step)>;
+};
+template<> struct WalkChildren<PartRef> {
+  using type = std::tuple<decltype(PartRef::name),
+      decltype(PartRef::subscripts), decltype(PartRef::imageSelector)>;
+};
+template<> struct WalkChildren<ReadStmt> {
+  using type = std::tuple<decltype(ReadStmt::iounit),
+      decltype(ReadStmt::format), decltype(ReadStmt::controls),
+      decltype(ReadStmt::items)>;
+};
+template<> struct WalkChildren<RealLiteralConstant> {
+  using type = std::tuple<decltype(RealLiteralConstant::real),
+      decltype(RealLiteralConstant::kind)>;
+};
+template<> struct WalkChildren<RealLiteralConstant::Real> {
+  using type = std::tuple<>;
+};
+template<> struct WalkChildren<StructureComponent> {
+  using type = std::tuple<decltype(StructureComponent::base),
+      decltype(StructureComponent::component)>;
+};
+template<> struct WalkChildren<Suffix> {
+  using type =
+      std::tuple<decltype(Suffix::binding), decltype(Suffix::resultName)>;
+};
+template<> struct WalkChildren<TypeBoundProcedureStmt::WithInterface> {
+  using type = std::tuple<
+      decltype(TypeBoundProcedureStmt::WithInterface::interfaceName),
+      decltype(TypeBoundProcedureStmt::WithInterface::attributes),
+      decltype(TypeBoundProcedureStmt::WithInterface::bindingNames)>;
+};
+template<> struct WalkChildren<TypeBoundProcedureStmt::WithoutInterface> {
+  using type =
+      std::tuple<decltype(TypeBoundProcedureStmt::WithoutInterface::attributes),
+          decltype(TypeBoundProcedureStmt::WithoutInterface::declarations)>;
+};
+template<> struct WalkChildren<UseStmt> {
+  using type = std::tuple<decltype(UseStmt::nature),
+      decltype(UseStmt::moduleName), decltype(UseStmt::u)>;
+};
+template<> struct WalkChildren<WriteStmt> {
+  using type = std::tuple<decltype(WriteStmt::iounit),
+      decltype(WriteStmt::format), decltype(WriteStmt::controls),
+      decltype(WriteStmt::items)>;
+};
+template<> struct WalkChildren<format::ControlEditDesc> {
+  using type = std::tuple<decltype(format::ControlEditDesc::kind)>;
+};
+template<> struct WalkChildren<format::DerivedTypeDataEditDesc> {
+  using type = std::tuple<decltype(format::DerivedTypeDataEditDesc::type),
+      decltype(format::DerivedTypeDataEditDesc::parameters)>;
+};
+template<> struct WalkChildren<format::FormatItem> {
+  using type = std::tuple<decltype(format::FormatItem::repeatCount),
+      decltype(format::FormatItem::u)>;
+};
+template<> struct WalkChildren<format::FormatSpecification> {
+  using type = std::tuple<decltype(format::FormatSpecification::items),
+      decltype(format::FormatSpecification::unlimitedItems)>;
+};
+template<> struct WalkChildren<format::IntrinsicTypeDataEditDesc> {
+  using type = std::tuple<decltype(format::IntrinsicTypeDataEditDesc::kind),
+      decltype(format::IntrinsicTypeDataEditDesc::width),
+      decltype(format::IntrinsicTypeDataEditDesc::digits),
+      decltype(format::IntrinsicTypeDataEditDesc::exponentWidth)>;
+};
+template<> struct WalkChildren<OmpLinearClause::WithModifier> {
+  using type = std::tuple<decltype(OmpLinearClause::WithModifier::modifier),
+      decltype(OmpLinearClause::WithModifier::names),
+      decltype(OmpLinearClause::WithModifier::step)>;
+};
+template<> struct WalkChildren<OmpLinearClause::WithoutModifier> {
+  using type = std::tuple<decltype(OmpLinearClause::WithoutModifier::names),
+      decltype(OmpLinearClause::WithoutModifier::step)>;
+};
+template<> struct WalkChildren<OpenMPDeclareTargetConstruct::WithClause> {
+  using type =
+      std::tuple<decltype(OpenMPDeclareTargetConstruct::WithClause::maptype),
+          decltype(OpenMPDeclareTargetConstruct::WithClause::names)>;
+};
+template<>
+struct WalkChildren<OpenMPDeclareTargetConstruct::WithExtendedList> {
+  using type = std::tuple<decltype(
+      OpenMPDeclareTargetConstruct::WithExtendedList::names)>;
+};
+
+template<typename V, typename = void>
+constexpr bool HasInterestingTypes{false};
+template<typename V>
+constexpr bool
+    HasInterestingTypes<V, std::void_t<typename V::InterestingTypes>>{true};
+
+template<typename A, typename INTERESTS> struct IsInterestingType;
+template<typename A, typename... INTERESTS>
+struct IsInterestingType<A, std::tuple<INTERESTS...>> {
+  static constexpr bool value{common::IsTypeInList<A, INTERESTS...>};
+};
+
+// The remembered answer for one pair of (interests, A).
+template<typename INTERESTS, typename A> struct WalkInterest {
+  static inline std::optional<bool> mayContain;
+};
+
+// The types reachable from some type, each with the types that can
+// directly contain it.  Interest is propagated from the interesting types
+// to everything that can contain them.
+class WalkInterestGraph {
+public:
+  // Returns the index of the type whose answer is remembered in *memo,
+  // and whether it is newly added.
+  std::pair<std::size_t, bool> AddType(
+      std::optional<bool> *memo, bool isInteresting) {
+    auto pair{index_.emplace(memo, types_.size())};
+    if (pair.second) {
+      types_.emplace_back(Type{memo, isInteresting, {}});
+    }
+    return {pair.first->second, pair.second};
+  }
+  void AddChild(std::size_t parent, std::size_t child) {
+    types_[child].parents.push_back(parent);
+  }
+  void Solve() {
+    std::vector<std::size_t> work;
+    for (std::size_t j{0}; j < types_.size(); ++j) {
+      if (types_[j].isInteresting) {
+        work.push_back(j);
+      }
+    }
+    while (!work.empty()) {
+      std::size_t j{work.back()};
+      work.pop_back();
+      for (std::size_t parent : types_[j].parents) {
+        if (!types_[parent].isInteresting) {
+          types_[parent].isInteresting = true;
+          work.push_back(parent);
+        }
+      }
+    }
+    for (const Type &type : types_) {
+      *type.memo = type.isInteresting;
+    }
+  }
+
+private:
+  struct Type {
+    std::optional<bool> *memo;
+    bool isInteresting;
+    std::vector<std::size_t> parents;
+  };
+  std::vector<Type> types_;
+  std::map<const std::optional<bool> *, std::size_t> index_;
+};
+
+template<typename INTERESTS, typename A>
+std::size_t AddToWalkInterestGraph(WalkInterestGraph &);
+
+template<typename INTERESTS, typename CHILDREN> struct WalkInterestChildren;
+template<typename INTERESTS, typename... CHILDREN>
+struct WalkInterestChildren<INTERESTS, std::tuple<CHILDREN...>> {
+  static void Add(WalkInterestGraph &graph, std::size_t parent) {
+    (graph.AddChild(parent, AddToWalkInterestGraph<INTERESTS, CHILDREN>(graph)),
+        ...);
+  }
+};
+
+template<typename INTERESTS, typename A>
+std::size_t AddToWalkInterestGraph(WalkInterestGraph &graph) {
+  using Children = typename WalkChildren<A>::type;
+  std::optional<bool> &memo{WalkInterest<INTERESTS, A>::mayContain};
+  bool isInteresting{IsInterestingType<A, INTERESTS>::value ||
+      std::is_void_v<Children> || memo.value_or(false)};
+  auto [j, isNew]{graph.AddType(&memo, isInteresting)};
+  if constexpr (!std::is_void_v<Children>) {
+    if (isNew && !isInteresting && !memo.has_value()) {
+      WalkInterestChildren<INTERESTS, Children>::Add(graph, j);
+    }
+  }
+  return j;
+}
+
+// Can a value of type A contain a node in which visitor type V is
+// interested?
+template<typename A, typename V> bool IsWorthWalking() {
+  if constexpr (HasInterestingTypes<V>) {
+    using Interests = typename V::InterestingTypes;
+    std::optional<bool> &memo{WalkInterest<Interests, A>::mayContain};
+    if (!memo.has_value()) {
+      WalkInterestGraph graph;
+      AddToWalkInterestGraph<Interests, A>(graph);
+      graph.Solve();
+    }
+    return *memo;
+  } else {
+    return true;
+  }
+}
+
 // Default case for visitation of non-class data members, strings, and
 // any other non-decomposable values.
 template<typename A, typename V>
 std::enable_if_t<!std::is_class_v<A> || std::is_same_v<std::string, A> ||
     std::is_same_v<CharBlock, A>>
 Walk(const A &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<A, V>() && visitor.Pre(x)) {
     visitor.Post(x);
   }
 }
@@ -47,7 +374,7 @@ template<typename A, typename M>
 std::enable_if_t<!std::is_class_v<A> || std::is_same_v<std::string, A> ||
     std::is_same_v<CharBlock, A>>
 Walk(A &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<A, M>() && mutator.Pre(x)) {
     mutator.Post(x);
   }
 }
@@ -66,12 +393,12 @@ template<typename M> void Walk(format::IntrinsicTypeDataEditDesc &, M &);
 // Traversal of needed STL template classes (optional, list, tuple, variant)
 template<typename T, typename V>
 void Walk(const std::optional<T> &x, V &visitor) {
-  if (x) {
+  if (x && IsWorthWalking<T, V>()) {
     Walk(*x, visitor);
   }
 }
 template<typename T, typename M> void Walk(std::optional<T> &x, M &mutator) {
-  if (x) {
+  if (x && IsWorthWalking<T, M>()) {
     Walk(*x, mutator);
   }
 }
@@ -79,17 +406,23 @@ template<typename T, typename M> void Walk(std::optional<T> &x, M &mutator) {
 // a Block (i.e., std::list<ExecutionPartConstruct>), also invoke the
 // visitor/mutator on the list itself.
 template<typename T, typename V> void Walk(const std::list<T> &x, V &visitor) {
+  if (!IsWorthWalking<T, V>()) {
+    return;
+  }
   for (const auto &elem : x) {
     Walk(elem, visitor);
   }
 }
 template<typename T, typename M> void Walk(std::list<T> &x, M &mutator) {
+  if (!IsWorthWalking<T, M>()) {
+    return;
+  }
   for (auto &elem : x) {
     Walk(elem, mutator);
   }
 }
 template<typename V> void Walk(const Block &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<Block, V>() && visitor.Pre(x)) {
     for (const auto &elem : x) {
       Walk(elem, visitor);
     }
@@ -97,12 +430,15 @@ template<typename V> void Walk(const Block &x, V &visitor) {
   }
 }
 template<typename M> void Walk(Block &x, M &mutator) {
+  if (!IsWorthWalking<Block, M>()) {
+    return;
+  }
   if (mutator.Pre(x)) {
     for (auto &elem : x) {
       Walk(elem, mutator);
     }
+    mutator.Post(x);
   }
-  mutator.Post(x);
 }
 template<std::size_t I = 0, typename Func, typename T>
 void ForEachInTuple(const T &tuple, Func func) {
@@ -113,7 +449,7 @@ void ForEachInTuple(const T &tuple, Func func) {
 }
 template<typename V, typename... A>
 void Walk(const std::tuple<A...> &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<std::tuple<A...>, V>() && visitor.Pre(x)) {
     ForEachInTuple(x, [&](const auto &y) { Walk(y, visitor); });
     visitor.Post(x);
   }
@@ -126,64 +462,66 @@ void ForEachInTuple(T &tuple, Func func) {
   }
 }
 template<typename M, typename... A> void Walk(std::tuple<A...> &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<std::tuple<A...>, M>() && mutator.Pre(x)) {
     ForEachInTuple(x, [&](auto &y) { Walk(y, mutator); });
     mutator.Post(x);
   }
 }
 template<typename V, typename... A>
 void Walk(const std::variant<A...> &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<std::variant<A...>, V>() && visitor.Pre(x)) {
     std::visit([&](const auto &y) { Walk(y, visitor); }, x);
     visitor.Post(x);
   }
 }
 template<typename M, typename... A>
 void Walk(std::variant<A...> &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<std::variant<A...>, M>() && mutator.Pre(x)) {
     std::visit([&](auto &y) { Walk(y, mutator); }, x);
     mutator.Post(x);
   }
 }
 template<typename A, typename B, typename V>
 void Walk(const std::pair<A, B> &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<std::pair<A, B>, V>() && visitor.Pre(x)) {
     Walk(x.first, visitor);
     Walk(x.second, visitor);
+    visitor.Post(x);
   }
 }
 template<typename A, typename B, typename M>
 void Walk(std::pair<A, B> &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<std::pair<A, B>, M>() && mutator.Pre(x)) {
     Walk(x.first, mutator);
     Walk(x.second, mutator);
+    mutator.Post(x);
   }
 }
 
 // Trait-determined traversal of empty, tuple, union, and wrapper classes.
 template<typename A, typename V>
 std::enable_if_t<EmptyTrait<A>> Walk(const A &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<A, V>() && visitor.Pre(x)) {
     visitor.Post(x);
   }
 }
 template<typename A, typename M>
 std::enable_if_t<EmptyTrait<A>> Walk(A &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<A, M>() && mutator.Pre(x)) {
     mutator.Post(x);
   }
 }
 
 template<typename A, typename V>
 std::enable_if_t<TupleTrait<A>> Walk(const A &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<A, V>() && visitor.Pre(x)) {
     Walk(x.t, visitor);
     visitor.Post(x);
   }
 }
 template<typename A, typename M>
 std::enable_if_t<TupleTrait<A>> Walk(A &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<A, M>() && mutator.Pre(x)) {
     Walk(x.t, mutator);
     mutator.Post(x);
   }
@@ -191,14 +529,14 @@ std::enable_if_t<TupleTrait<A>> Walk(A &x, M &mutator) {
 
 template<typename A, typename V>
 std::enable_if_t<UnionTrait<A>> Walk(const A &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<A, V>() && visitor.Pre(x)) {
     Walk(x.u, visitor);
     visitor.Post(x);
   }
 }
 template<typename A, typename M>
 std::enable_if_t<UnionTrait<A>> Walk(A &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<A, M>() && mutator.Pre(x)) {
     Walk(x.u, mutator);
     mutator.Post(x);
   }
@@ -206,14 +544,14 @@ std::enable_if_t<UnionTrait<A>> Walk(A &x, M &mutator) {
 
 template<typename A, typename V>
 std::enable_if_t<WrapperTrait<A>> Walk(const A &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<A, V>() && visitor.Pre(x)) {
     Walk(x.v, visitor);
     visitor.Post(x);
   }
 }
 template<typename A, typename M>
 std::enable_if_t<WrapperTrait<A>> Walk(A &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<A, M>() && mutator.Pre(x)) {
     Walk(x.v, mutator);
     mutator.Post(x);
   }
@@ -221,11 +559,15 @@ std::enable_if_t<WrapperTrait<A>> Walk(A &x, M &mutator) {
 
 template<typename T, typename V>
 void Walk(const common::Indirection<T> &x, V &visitor) {
-  Walk(*x, visitor);
+  if (IsWorthWalking<T, V>()) {
+    Walk(*x, visitor);
+  }
 }
 template<typename T, typename M>
 void Walk(common::Indirection<T> &x, M &mutator) {
-  Walk(*x, mutator);
+  if (IsWorthWalking<T, M>()) {
+    Walk(*x, mutator);
+  }
 }
 
 // Walk a class with a single field 'thing'.
@@ -262,14 +604,14 @@ template<typename T, typename M> void Walk(DefaultChar<T> &x, M &mutator) {
 }
 
 template<typename T, typename V> void Walk(const Statement<T> &x, V &visitor) {
-  if (visitor.Pre(x)) {
+  if (IsWorthWalking<Statement<T>, V>() && visitor.Pre(x)) {
     // N.B. the label is not traversed
     Walk(x.statement, visitor);
     visitor.Post(x);
   }
 }
 template<typename T, typename M> void Walk(Statement<T> &x, M &mutator) {
-  if (mutator.Pre(x)) {
+  if (IsWorthWalking<Statement<T>, M>() && mutator.Pre(x)) {
     // N.B. the label is not traversed
     Walk(x.statement, mutator);
     mutator.Post(x);
@@ -757,5 +1099,76 @@ void Walk(OpenMPDeclareTargetConstruct::WithExtendedList &x, M &mutator) {
     mutator.Post(x);
   }
 }
+
+// Walk(x, visitor1, visitor2, ...) traverses x once on behalf of several
+// visitors or mutators, calling the Pre() and Post() of each in the order
+// given.  When one of them declines a subtree, because its Pre() returns
+// false or because the subtree cannot contain a node in which it is
+// interested, it is suspended until that subtree is done while the others
+// continue.  The group itself declares the union of its members' interests
+// when all of them declare interests, so it prunes what none of them need.
+template<bool ALL_DECLARE, typename... V> struct WalkGroupInterests {};
+template<typename... V> struct WalkGroupInterests<true, V...> {
+  using InterestingTypes = decltype(
+      std::tuple_cat(std::declval<typename V::InterestingTypes>()...));
+};
+
+template<typename... V>
+class WalkGroup
+  : public WalkGroupInterests<(HasInterestingTypes<V> && ...), V...> {
+public:
+  explicit WalkGroup(V &... visitors) : visitors_{visitors...} {}
+
+  template<typename A> bool Pre(A &x) {
+    return Pre(x, std::index_sequence_for<V...>{});
+  }
+  template<typename A> void Post(A &x) {
+    --depth_;
+    Post(x, std::index_sequence_for<V...>{});
+  }
+
+private:
+  template<typename A, std::size_t... J>
+  bool Pre(A &x, std::index_sequence<J...>) {
+    (PreOne<J>(x), ...);
+    if ((suspendedAt_[J].has_value() && ...)) {
+      // Nobody wants this subtree; it won't be traversed.
+      ((suspendedAt_[J] == depth_ ? suspendedAt_[J].reset() : void()), ...);
+      return false;
+    }
+    ++depth_;
+    return true;
+  }
+  template<std::size_t J, typename A> void PreOne(A &x) {
+    using Visitor = std::tuple_element_t<J, std::tuple<V...>>;
+    if (!suspendedAt_[J].has_value()) {
+      if (!IsWorthWalking<std::remove_const_t<A>, Visitor>() ||
+          !std::get<J>(visitors_).Pre(x)) {
+        suspendedAt_[J] = depth_;
+      }
+    }
+  }
+  template<typename A, std::size_t... J>
+  void Post(A &x, std::index_sequence<J...>) {
+    (PostOne<J>(x), ...);
+  }
+  template<std::size_t J, typename A> void PostOne(A &x) {
+    if (!suspendedAt_[J].has_value()) {
+      std::get<J>(visitors_).Post(x);
+    } else if (*suspendedAt_[J] == depth_) {
+      suspendedAt_[J].reset();  // done with the subtree that it declined
+    }
+  }
+
+  std::tuple<V &...> visitors_;
+  std::array<std::optional<int>, sizeof...(V)> suspendedAt_;
+  int depth_{0};
+};
+
+template<typename A, typename V1, typename V2, typename... Vs>
+void Walk(A &x, V1 &visitor1, V2 &visitor2, Vs &... visitors) {
+  WalkGroup<V1, V2, Vs...> group{visitor1, visitor2, visitors...};
+  Walk(x, group);
+}
 }
 #endif  // FORTRAN_PARSER_PARSE_TREE_VISITOR_H_
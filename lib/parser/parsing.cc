@@ -17,16 +17,24 @@
 #include "instrumented-parser.h"
 #include "message.h"
 #include "openmp-grammar.h"
+#include "parse-tree-cache.h"
+#include "parse-tree-visitor.h"
 #include "preprocessor.h"
 #include "prescan.h"
 #include "provenance.h"
 #include "source.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <sstream>
+#include <type_traits>
+#include <variant>
 
 namespace Fortran::parser {
 
-Parsing::Parsing() {}
-Parsing::Parsing(AllSources &s) : cooked_{s} {}
+Parsing::Parsing() : cooked_{std::make_unique<CookedSource>()} {}
+Parsing::Parsing(AllSources &s)
+  : cooked_{std::make_unique<CookedSource>(s)} {}
 
 Parsing::~Parsing() {}
 
@@ -35,7 +43,8 @@ void Parsing::Prescan(const std::string &path, Options options) {
 
   std::stringstream fileError;
   const SourceFile *sourceFile;
-  AllSources &allSources{cooked_.allSources()};
+  AllSources &allSources{cooked_->allSources()};
+  prescanned_.first = allSources.size();
   if (path == "-") {
     sourceFile = allSources.ReadStandardInput(&fileError);
   } else {
@@ -44,11 +53,13 @@ void Parsing::Prescan(const std::string &path, Options options) {
   if (sourceFile == nullptr) {
     ProvenanceRange range{allSources.AddCompilerInsertion(path)};
     messages_.Say(range, "%s"_err_en_US, fileError.str().data());
+    prescanned_.second = allSources.size();
     return;
   }
   if (sourceFile->bytes() == 0) {
     ProvenanceRange range{allSources.AddCompilerInsertion(path)};
     messages_.Say(range, "file is empty"_err_en_US);
+    prescanned_.second = allSources.size();
     return;
   }
 
@@ -68,7 +79,7 @@ void Parsing::Prescan(const std::string &path, Options options) {
       preprocessor.Undefine(predef.first);
     }
   }
-  Prescanner prescanner{messages_, cooked_, preprocessor, options.features};
+  Prescanner prescanner{messages_, *cooked_, preprocessor, options.features};
   prescanner.set_fixedForm(options.isFixedForm)
       .set_fixedFormColumnLimit(options.fixedFormColumns)
       .set_encoding(options.encoding)
@@ -80,30 +91,40 @@ void Parsing::Prescan(const std::string &path, Options options) {
   ProvenanceRange range{allSources.AddIncludedFile(
       *sourceFile, ProvenanceRange{}, options.isModuleFile)};
   prescanner.Prescan(range);
-  cooked_.Marshal();
+  cooked_->Marshal();
+  prescanned_.second = allSources.size();
 }
 
 void Parsing::DumpCookedChars(std::ostream &out) const {
-  UserState userState{cooked_, LanguageFeatureControl{}};
-  ParseState parseState{cooked_};
+  UserState userState{*cooked_, LanguageFeatureControl{}};
+  ParseState parseState{*cooked_};
   parseState.set_inFixedForm(options_.isFixedForm).set_userState(&userState);
   while (std::optional<const char *> p{parseState.GetNextChar()}) {
     out << **p;
   }
 }
 
-void Parsing::DumpProvenance(std::ostream &out) const { cooked_.Dump(out); }
+void Parsing::DumpProvenance(std::ostream &out) const { cooked_->Dump(out); }
 
 void Parsing::DumpParsingLog(std::ostream &out) const {
-  log_.Dump(out, cooked_);
+  log_.Dump(out, *cooked_);
+}
+
+void Parsing::DumpParsingProfile(std::ostream &out) const {
+  profile_.Dump(out);
 }
 
 void Parsing::Parse(std::ostream *out) {
-  UserState userState{cooked_, options_.features};
-  userState.set_debugOutput(out)
-      .set_instrumentedParse(options_.instrumentedParse)
-      .set_log(&log_);
-  ParseState parseState{cooked_};
+  UserState userState{*cooked_, options_.features};
+  userState.set_debugOutput(out).set_instrumentedParse(
+      options_.instrumentedParse);
+  if (options_.profileParse) {
+    userState.set_profile(&profile_);
+  }
+  if (options_.instrumentedParse || !options_.profileParse) {
+    userState.set_log(&log_);  // a profile would include its costs
+  }
+  ParseState parseState{*cooked_};
   parseState.set_inFixedForm(options_.isFixedForm)
       .set_encoding(options_.encoding)
       .set_userState(&userState);
@@ -115,17 +136,241 @@ void Parsing::Parse(std::ostream *out) {
   finalRestingPlace_ = parseState.GetLocation();
 }
 
-void Parsing::ClearLog() { log_.clear(); }
+// Renders the options that affect prescanning and parsing.
+static std::string ParseTreeKey(const Options &options) {
+  std::stringstream key;
+  key << options.isFixedForm << ' ' << options.fixedFormColumns << ' '
+      << options.isStrictlyStandard << ' '
+      << static_cast<int>(options.encoding) << ' ' << options.isModuleFile << '\n';
+  for (std::size_t j{0}; j < LanguageFeature_enumSize; ++j) {
+    auto feature{static_cast<LanguageFeature>(j)};
+    key << options.features.IsEnabled(feature)
+        << options.features.ShouldWarn(feature);
+  }
+  key << '\n';
+  for (const auto &path : options.searchDirectories) {
+    key << "-I" << path << '\n';
+  }
+  for (const auto &predef : options.predefinitions) {
+    if (predef.second.has_value()) {
+      key << "-D" << predef.first << '=' << *predef.second << '\n';
+    } else {
+      key << "-U" << predef.first << '\n';
+    }
+  }
+  return key.str();
+}
+
+bool Parsing::SaveParseTree(std::ostream &out) const {
+  CHECK(parseTree_.has_value());
+  return parser::SaveParseTree(
+      out, ParseTreeKey(options_), *parseTree_, *cooked_);
+}
+
+bool Parsing::LoadParseTree(std::istream &in, Options options) {
+  AllSources &allSources{cooked_->allSources()};
+  std::size_t before{allSources.size()};
+  parseTree_ = parser::LoadParseTree(in, ParseTreeKey(options), *cooked_);
+  if (!parseTree_.has_value()) {
+    // Discard anything that was loaded before the failure, so that the
+    // source file can be prescanned instead.
+    allSources.Truncate(before);
+    cooked_ = std::make_unique<CookedSource>(allSources);
+    return false;
+  }
+  options_ = options;
+  consumedWholeFile_ = true;
+  finalRestingPlace_ = cooked_->data().data() + cooked_->data().size();
+  return true;
+}
+
+// Moves the CharBlocks and other locations in a retained program unit
+// from the previous cooked character stream into the new one, and
+// discards the results of any semantic analysis.
+class ParseTreeRelocator {
+public:
+  ParseTreeRelocator(const char *from, const char *to, std::ptrdiff_t shift)
+    : from_{from}, to_{to}, shift_{shift} {}
+
+  template<typename A> bool Pre(A &) { return true; }
+  template<typename A> void Post(A &) {}
+
+  template<typename A> bool Pre(Statement<A> &x) {
+    Relocate(x.source);
+    return true;
+  }
+  bool Pre(Name &x) {
+    Relocate(x.source);
+    x.symbol = nullptr;
+    return true;
+  }
+  bool Pre(Expr &x) {
+    Relocate(x.source);
+    x.typedExpr.reset(nullptr);
+    return true;
+  }
+  bool Pre(SignedIntLiteralConstant &x) {
+    Relocate(x.source);
+    return true;
+  }
+  bool Pre(RealLiteralConstant::Real &x) {
+    Relocate(x.source);
+    return true;
+  }
+  bool Pre(CompilerDirective &x) {
+    Relocate(x.source);
+    return true;
+  }
+  bool Pre(const char *&x) {
+    x = Relocate(x);
+    return true;
+  }
+
+private:
+  const char *Relocate(const char *p) const {
+    return to_ + ((p - from_) + shift_);
+  }
+  void Relocate(CharBlock &x) const {
+    if (!x.empty()) {
+      x = CharBlock{Relocate(x.begin()), x.size()};
+    }
+  }
+
+  const char *from_, *to_;
+  std::ptrdiff_t shift_;
+};
+
+std::pair<std::size_t, std::size_t> Parsing::Reparse(
+    const std::string &path, Options options) {
+  bool reusable{parseTree_.has_value() && consumedWholeFile_ &&
+      messages_.empty() && !options.instrumentedParse &&
+      !options.profileParse && ParseTreeKey(options) == ParseTreeKey(options_)};
+  // The previous parse tree's CharBlocks remain valid in the previous
+  // CookedSource.  The provenances of the previous prescan are released
+  // for reuse, unless others have been allocated after them.
+  std::unique_ptr<CookedSource> previousCooked{std::move(cooked_)};
+  AllSources &allSources{previousCooked->allSources()};
+  if (allSources.size() == prescanned_.second) {
+    allSources.Truncate(prescanned_.first);
+  }
+  cooked_ = std::make_unique<CookedSource>(allSources);
+  const std::string &previous{previousCooked->data()};
+  messages_ = Messages{};
+  log_.clear();  // its entries are keyed by locations in "previous"
+  Prescan(path, options);
+  if (messages_.AnyFatalError()) {
+    parseTree_.reset();
+    consumedWholeFile_ = false;
+    return {0, 0};
+  }
+  if (!reusable) {
+    Parse();
+    return {0, parseTree_.has_value() ? parseTree_->v.size() : 0};
+  }
+
+  // Find the common prefix and suffix of the previous and new cooked
+  // character streams.
+  const std::string &current{cooked_->data()};
+  std::size_t oldBytes{previous.size()}, newBytes{current.size()};
+  std::size_t prefix{0};
+  std::size_t maxCommon{std::min(oldBytes, newBytes)};
+  while (prefix < maxCommon && previous[prefix] == current[prefix]) {
+    ++prefix;
+  }
+  std::size_t suffix{0};
+  while (suffix < maxCommon - prefix &&
+      previous[oldBytes - 1 - suffix] == current[newBytes - 1 - suffix]) {
+    ++suffix;
+  }
+
+  // A program unit comprises whole lines (see the grammar for Program).
+  // Each one ends with the line of its END statement and begins just
+  // after the end of the previous one.
+  std::list<ProgramUnit> &units{parseTree_->v};
+  std::vector<std::size_t> ends;
+  for (const ProgramUnit &unit : units) {
+    CharBlock endStmt{std::visit(
+        [](const auto &indirection) {
+          const auto &t{(*indirection).t};
+          using Tuple = std::decay_t<decltype(t)>;
+          return std::get<std::tuple_size_v<Tuple> - 1>(t).source;
+        },
+        unit.u)};
+    auto newline{previous.find('\n', endStmt.end() - previous.data())};
+    ends.push_back(newline == std::string::npos ? oldBytes : newline + 1);
+  }
+  auto begins{[&](std::size_t j) { return j == 0 ? 0 : ends[j - 1]; }};
+  // Program units [0, first) lie wholly in the common prefix, and units
+  // [last, n) lie wholly in the common suffix and still begin new lines;
+  // the others must be parsed anew.
+  std::size_t n{units.size()};
+  std::size_t first{0};
+  while (first < n && ends[first] <= prefix) {
+    ++first;
+  }
+  auto newBegin{[&](std::size_t j) { return begins(j) + newBytes - oldBytes; }};
+  std::size_t last{first};
+  while (last < n &&
+      (begins(last) < oldBytes - suffix ||
+          (newBegin(last) == 0 ? begins(last) != 0
+                               : current[newBegin(last) - 1] != '\n'))) {
+    ++last;
+  }
+  std::size_t from{begins(first)};
+  std::size_t to{last < n ? newBegin(last) : newBytes};
+
+  std::list<ProgramUnit> fresh;
+  if (to > from) {
+    UserState userState{*cooked_, options_.features};
+    ParseState parseState{CharBlock{&current[from], to - from}};
+    parseState.set_inFixedForm(options_.isFixedForm)
+        .set_encoding(options_.encoding)
+        .set_userState(&userState);
+    std::optional<Program> changed{program.Parse(parseState)};
+    if (!changed.has_value() || !parseState.IsAtEnd()) {
+      // The changed lines can't be parsed apart from the others.
+      Parse();
+      return {0, parseTree_.has_value() ? parseTree_->v.size() : 0};
+    }
+    CHECK(!parseState.anyErrorRecovery() ||
+        parseState.messages().AnyFatalError());
+    messages_.Annex(std::move(parseState.messages()));
+    fresh = std::move(changed->v);
+  }
+
+  std::size_t parsed{fresh.size()};
+  auto iter{units.begin()};
+  ParseTreeRelocator inPrefix{previous.data(), current.data(), 0};
+  for (std::size_t j{0}; j < first; ++j, ++iter) {
+    Walk(*iter, inPrefix);
+  }
+  iter = units.erase(iter, std::next(iter, last - first));
+  units.splice(iter, fresh);
+  ParseTreeRelocator inSuffix{previous.data(), current.data(),
+      static_cast<std::ptrdiff_t>(newBytes) -
+          static_cast<std::ptrdiff_t>(oldBytes)};
+  for (; iter != units.end(); ++iter) {
+    Walk(*iter, inSuffix);
+  }
+  consumedWholeFile_ = true;
+  finalRestingPlace_ = current.data() + newBytes;
+  return {first, first + parsed};
+}
+
+void Parsing::ClearLog() {
+  log_.clear();
+  profile_.clear();
+}
 
 bool Parsing::ForTesting(std::string path, std::ostream &err) {
   Prescan(path, Options{});
   if (messages_.AnyFatalError()) {
-    messages_.Emit(err, cooked_);
+    messages_.Emit(err, *cooked_);
     err << "could not scan " << path << '\n';
     return false;
   }
   Parse();
-  messages_.Emit(err, cooked_);
+  messages_.Emit(err, *cooked_);
   if (!consumedWholeFile_) {
     EmitMessage(err, finalRestingPlace_, "parser FAIL; final position");
     return false;
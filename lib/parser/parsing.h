@@ -21,6 +21,8 @@
 #include "message.h"
 #include "parse-tree.h"
 #include "provenance.h"
+#include <iosfwd>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -42,6 +44,7 @@ struct Options {
   std::vector<std::string> searchDirectories;
   std::vector<Predefinition> predefinitions;
   bool instrumentedParse{false};
+  bool profileParse{false};
   bool isModuleFile{false};
 };
 
@@ -54,7 +57,7 @@ public:
 
   bool consumedWholeFile() const { return consumedWholeFile_; }
   const char *finalRestingPlace() const { return finalRestingPlace_; }
-  CookedSource &cooked() { return cooked_; }
+  CookedSource &cooked() { return *cooked_; }
   Messages &messages() { return messages_; }
   std::optional<Program> &parseTree() { return parseTree_; }
 
@@ -62,25 +65,45 @@ public:
   void DumpCookedChars(std::ostream &) const;
   void DumpProvenance(std::ostream &) const;
   void DumpParsingLog(std::ostream &) const;
+  void DumpParsingProfile(std::ostream &) const;
   void Parse(std::ostream *debugOutput = nullptr);
   void ClearLog();
 
+  // Saves the results of Prescan() and Parse(), or restores them in place
+  // of calling Prescan() and Parse() with the same options; see
+  // parse-tree-cache.h.  Restoration fails when a source file has changed.
+  bool SaveParseTree(std::ostream &) const;
+  bool LoadParseTree(std::istream &, Options);
+
+  // For editors: after a Prescan() and Parse() that produced no messages,
+  // prescans the source file again and parses only the program units
+  // whose cooked characters have changed, splicing them into the parse
+  // tree in place of their previous versions.  The other program units
+  // are retained, but any results of semantic analysis in them are
+  // discarded.  Returns the indices [first, last) in the parse tree of
+  // the program units that were parsed anew; when the previous parse
+  // can't be reused, all of them are.
+  std::pair<std::size_t, std::size_t> Reparse(const std::string &path, Options);
+
   void EmitMessage(std::ostream &o, const char *at, const std::string &message,
       bool echoSourceLine = false) const {
-    cooked_.allSources().EmitMessage(
-        o, cooked_.GetProvenanceRange(CharBlock(at)), message, echoSourceLine);
+    cooked_->allSources().EmitMessage(o,
+        cooked_->GetProvenanceRange(CharBlock(at)), message, echoSourceLine);
   }
 
   bool ForTesting(std::string path, std::ostream &);
 
 private:
   Options options_;
-  CookedSource cooked_;
+  std::unique_ptr<CookedSource> cooked_;
+  // allSources().size() before and after the last Prescan()
+  std::pair<std::size_t, std::size_t> prescanned_{0, 0};
   Messages messages_;
   bool consumedWholeFile_{false};
   const char *finalRestingPlace_{nullptr};
   std::optional<Program> parseTree_;
   ParsingLog log_;
+  ParsingProfile profile_;
 };
 }
 #endif  // FORTRAN_PARSER_PARSING_H_
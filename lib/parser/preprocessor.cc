@@ -605,7 +605,7 @@ void Preprocessor::SkipDisabledConditionalCode(const std::string &dirName,
   int nesting{0};
   while (!prescanner->IsAtEnd()) {
     if (!prescanner->IsNextLinePreprocessorDirective()) {
-      prescanner->NextLine();
+      prescanner->SkipToNextPossiblePreprocessorDirective();
       continue;
     }
     TokenSequence line{prescanner->TokenizePreprocessorDirective()};
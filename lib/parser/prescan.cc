@@ -19,6 +19,7 @@
 #include "source.h"
 #include "token-sequence.h"
 #include "../common/idioms.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <sstream>
@@ -259,9 +260,12 @@ void Prescanner::LabelField(TokenSequence &token, int outCol) {
 }
 
 void Prescanner::SkipToEndOfLine() {
-  while (*at_ != '\n') {
-    ++at_, ++column_;
-  }
+  const void *vat{static_cast<const void *>(at_)};
+  const void *vnl{std::memchr(vat, '\n', limit_ - at_)};
+  const char *nl{static_cast<const char *>(vnl)};
+  CHECK(nl != nullptr);
+  column_ += nl - at_;
+  at_ = nl;
 }
 
 void Prescanner::NextChar() {
@@ -668,6 +672,35 @@ bool Prescanner::IsNextLinePreprocessorDirective() const {
   return IsPreprocessorDirectiveLine(lineStart_) != nullptr;
 }
 
+// Advances from the next line to the first later line that contains
+// a '#' anywhere, or to the end of the source.
+void Prescanner::SkipToNextPossiblePreprocessorDirective() {
+  if (!linesWithHash_.has_value()) {
+    linesWithHash_.emplace();
+    for (const char *p{start_}; p < limit_;) {
+      const void *vp{static_cast<const void *>(p)};
+      const void *vhash{std::memchr(vp, '#', limit_ - p)};
+      if (vhash == nullptr) {
+        break;
+      }
+      const char *hash{static_cast<const char *>(vhash)};
+      const char *line{hash};
+      while (line > start_ && line[-1] != '\n') {
+        --line;
+      }
+      linesWithHash_->push_back(line);
+      const void *vnl{std::memchr(vhash, '\n', limit_ - hash)};
+      if (vnl == nullptr) {
+        break;
+      }
+      p = static_cast<const char *>(vnl) + 1;
+    }
+  }
+  auto iter{std::upper_bound(
+      linesWithHash_->begin(), linesWithHash_->end(), lineStart_)};
+  lineStart_ = iter == linesWithHash_->end() ? limit_ : *iter;
+}
+
 bool Prescanner::SkipCommentLine() {
   if (lineStart_ >= limit_) {
     return false;
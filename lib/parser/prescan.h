@@ -31,6 +31,7 @@
 #include <optional>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace Fortran::parser {
 
@@ -67,6 +68,7 @@ public:
   // Callbacks for use by Preprocessor.
   bool IsAtEnd() const { return lineStart_ >= limit_; }
   bool IsNextLinePreprocessorDirective() const;
+  void SkipToNextPossiblePreprocessorDirective();
   TokenSequence TokenizePreprocessorDirective();
   Provenance GetCurrentProvenance() const { return GetProvenance(at_); }
 
@@ -205,6 +207,11 @@ private:
   const ProvenanceRange sixSpaceProvenance_{
       cooked_.allSources().AddCompilerInsertion("      "s)};
 
+  // Starts of the lines in the current source that contain a '#', found
+  // once on demand, so that disabled conditional code can be skipped
+  // without visiting each of its lines.
+  std::optional<std::vector<const char *>> linesWithHash_;
+
   // To avoid probing the set of active compiler directive sentinel strings
   // on every comment line, they're checked first with a cheap Bloom filter.
   static const int prime1{1019}, prime2{1021};
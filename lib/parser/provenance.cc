@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include "provenance.h"
+#include "binary-stream.h"
 #include "../common/idioms.h"
+#include <algorithm>
+#include <set>
 #include <utility>
 
 namespace Fortran::parser {
@@ -82,6 +85,42 @@ void OffsetToProvenanceMappings::RemoveLastBytes(std::size_t bytes) {
   }
 }
 
+static void PutProvenanceRange(BinaryWriter &writer, ProvenanceRange range) {
+  writer.Put(range.start().offset());
+  writer.Put(range.size());
+}
+
+static ProvenanceRange GetProvenanceRange(BinaryReader &reader) {
+  std::size_t offset{reader.Get()};
+  std::size_t size{reader.Get()};
+  if (offset == 0) {
+    return {};
+  }
+  if (offset > maxProvenanceOffset || size > maxProvenanceOffset - offset) {
+    reader.Fail();
+    return {};
+  }
+  return {Provenance{offset}, size};
+}
+
+void OffsetToProvenanceMappings::Save(BinaryWriter &writer) const {
+  writer.Put(provenanceMap_.size());
+  for (const ContiguousProvenanceMapping &map : provenanceMap_) {
+    PutProvenanceRange(writer, map.range);
+  }
+}
+
+void OffsetToProvenanceMappings::Load(BinaryReader &reader) {
+  for (std::size_t n{reader.GetSize()}; n > 0; --n) {
+    ProvenanceRange range{GetProvenanceRange(reader)};
+    if (range.empty()) {
+      reader.Fail();  // no mapping is ever saved empty
+      return;
+    }
+    Put(range);
+  }
+}
+
 AllSources::AllSources() : range_{1, 1} {
   // Start the origin_ array with a dummy entry that has a forced provenance,
   // so that provenance offset 0 remains reserved as an uninitialized
@@ -123,32 +162,69 @@ const SourceFile *AllSources::ReadStandardInput(std::stringstream *error) {
   return nullptr;
 }
 
-ProvenanceRange AllSources::AddIncludedFile(
-    const SourceFile &source, ProvenanceRange from, bool isModule) {
-  ProvenanceRange covers{range_.NextAfter(), source.bytes()};
+ProvenanceRange AllSources::AllocateRange(std::size_t bytes) {
+  std::size_t next{range_.NextAfter().offset()};
+  CHECK(bytes <= maxProvenanceOffset && next <= maxProvenanceOffset - bytes &&
+      "total source size exceeds compact provenance limit");
+  ProvenanceRange covers{range_.NextAfter(), bytes};
   CHECK(range_.AnnexIfPredecessor(covers));
   CHECK(origin_.back().covers.ImmediatelyPrecedes(covers));
+  return covers;
+}
+
+ProvenanceRange AllSources::AddIncludedFile(
+    const SourceFile &source, ProvenanceRange from, bool isModule) {
+  ProvenanceRange covers{AllocateRange(source.bytes())};
   origin_.emplace_back(covers, source, from, isModule);
   return covers;
 }
 
 ProvenanceRange AllSources::AddMacroCall(
     ProvenanceRange def, ProvenanceRange use, const std::string &expansion) {
-  ProvenanceRange covers{range_.NextAfter(), expansion.size()};
-  CHECK(range_.AnnexIfPredecessor(covers));
-  CHECK(origin_.back().covers.ImmediatelyPrecedes(covers));
+  ProvenanceRange covers{AllocateRange(expansion.size())};
   origin_.emplace_back(covers, def, use, expansion);
   return covers;
 }
 
 ProvenanceRange AllSources::AddCompilerInsertion(std::string text) {
-  ProvenanceRange covers{range_.NextAfter(), text.size()};
-  CHECK(range_.AnnexIfPredecessor(covers));
-  CHECK(origin_.back().covers.ImmediatelyPrecedes(covers));
+  ProvenanceRange covers{AllocateRange(text.size())};
   origin_.emplace_back(covers, text);
   return covers;
 }
 
+void AllSources::Truncate(std::size_t bytes) {
+  CHECK(bytes > 0 && bytes <= range_.size());
+  Provenance end{range_.start() + bytes};
+  std::set<const SourceFile *> discarded;
+  while (end < origin_.back().covers.NextAfter()) {
+    CHECK(end <= origin_.back().covers.start());
+    if (const auto *inc{std::get_if<Inclusion>(&origin_.back().u)}) {
+      discarded.insert(&inc->source);
+    }
+    origin_.pop_back();  // Origin is not assignable
+  }
+  for (const Origin &origin : origin_) {
+    if (const auto *inc{std::get_if<Inclusion>(&origin.u)}) {
+      discarded.erase(&inc->source);
+    }
+  }
+  ownedSourceFiles_.erase(
+      std::remove_if(ownedSourceFiles_.begin(), ownedSourceFiles_.end(),
+          [&](const std::unique_ptr<SourceFile> &source) {
+            return discarded.find(source.get()) != discarded.end();
+          }),
+      ownedSourceFiles_.end());
+  for (auto iter{compilerInsertionProvenance_.begin()};
+       iter != compilerInsertionProvenance_.end();) {
+    if (iter->second < end) {
+      ++iter;
+    } else {
+      iter = compilerInsertionProvenance_.erase(iter);
+    }
+  }
+  range_ = ProvenanceRange{range_.start(), bytes};
+}
+
 void AllSources::EmitMessage(std::ostream &o,
     const std::optional<ProvenanceRange> &range, const std::string &message,
     bool echoSourceLine) const {
@@ -251,6 +327,23 @@ std::string AllSources::GetPath(Provenance at) const {
   return source ? source->path() : ""s;
 }
 
+// Paths of INCLUDE and #include files, without duplicates, in order of
+// their first inclusions; module files read for USE are not included.
+std::vector<std::string> AllSources::GetIncludedFilePaths() const {
+  std::vector<std::string> result;
+  for (const Origin &origin : origin_) {
+    if (const auto *inc{std::get_if<Inclusion>(&origin.u)}) {
+      if (!inc->isModule && IsValid(origin.replaces)) {
+        std::string path{inc->source.path()};
+        if (std::find(result.begin(), result.end(), path) == result.end()) {
+          result.emplace_back(std::move(path));
+        }
+      }
+    }
+  }
+  return result;
+}
+
 int AllSources::GetLineNumber(Provenance at) const {
   std::size_t offset{0};
   const SourceFile *source{GetSourceFile(at, &offset)};
@@ -268,6 +361,85 @@ Provenance AllSources::CompilerInsertionProvenance(char ch) {
   return newCharProvenance;
 }
 
+void AllSources::Save(BinaryWriter &writer) const {
+  writer.Put(origin_.size() - 1);  // not the initial dummy origin
+  for (std::size_t j{1}; j < origin_.size(); ++j) {
+    const Origin &origin{origin_[j]};
+    writer.Put(origin.u.index());
+    std::visit(
+        common::visitors{
+            [&](const Inclusion &inc) {
+              writer.Put(inc.source.path());
+              writer.Put(inc.source.bytes());
+              writer.Put(HashBytes(inc.source.content(), inc.source.bytes()));
+              writer.Put(inc.isModule);
+            },
+            [&](const Macro &mac) {
+              PutProvenanceRange(writer, mac.definition);
+              writer.Put(mac.expansion);
+            },
+            [&](const CompilerInsertion &ins) { writer.Put(ins.text); }},
+        origin.u);
+    PutProvenanceRange(writer, origin.replaces);
+  }
+  writer.Put(range_.size());
+}
+
+bool AllSources::Load(BinaryReader &reader) {
+  if (origin_.size() != 1) {
+    return false;  // provenances would differ
+  }
+  // All of the source files are checked before any origin is added.
+  struct Saved {
+    std::uint64_t which;
+    std::string text;  // path, macro expansion, or inserted text
+    const SourceFile *source{nullptr};
+    bool isModule{false};
+    ProvenanceRange definition, replaces;
+  };
+  std::vector<Saved> saved;
+  for (std::size_t n{reader.GetSize()}; n > 0; --n) {
+    Saved &next{saved.emplace_back(Saved{reader.Get(), {}})};
+    if (next.which == 0) {  // Inclusion
+      next.text = reader.GetString();
+      std::size_t bytes{reader.Get()};
+      std::uint64_t hash{reader.Get()};
+      next.isModule = reader.Get() != 0;
+      std::stringstream error;
+      next.source = Open(next.text, &error);
+      if (next.source == nullptr || next.source->bytes() != bytes ||
+          HashBytes(next.source->content(), bytes) != hash) {
+        return false;
+      }
+    } else if (next.which == 1) {  // Macro
+      next.definition = GetProvenanceRange(reader);
+      next.text = reader.GetString();
+    } else if (next.which == 2) {  // CompilerInsertion
+      next.text = reader.GetString();
+    } else {
+      reader.Fail();
+    }
+    next.replaces = GetProvenanceRange(reader);
+  }
+  std::size_t size{reader.Get()};
+  if (!reader.ok()) {
+    return false;
+  }
+  for (const Saved &next : saved) {
+    if (next.which == 0) {
+      AddIncludedFile(*next.source, next.replaces, next.isModule);
+    } else if (next.which == 1) {
+      AddMacroCall(next.definition, next.replaces, next.text);
+    } else {
+      ProvenanceRange covers{AddCompilerInsertion(next.text)};
+      if (next.text.size() == 1) {
+        compilerInsertionProvenance_.emplace(next.text[0], covers.start());
+      }
+    }
+  }
+  return range_.size() == size;
+}
+
 AllSources::Origin::Origin(ProvenanceRange r, const SourceFile &source)
   : u{Inclusion{source}}, covers{r} {}
 AllSources::Origin::Origin(ProvenanceRange r, const SourceFile &included,
@@ -332,6 +504,22 @@ void CookedSource::Marshal() {
   buffer_.clear();
 }
 
+void CookedSource::Save(BinaryWriter &writer) const {
+  allSources_->Save(writer);
+  writer.Put(data_);
+  provenanceMap_.Save(writer);
+}
+
+bool CookedSource::Load(BinaryReader &reader) {
+  CHECK(buffer_.empty() && data_.empty() && provenanceMap_.size() == 0);
+  if (!allSources_->Load(reader)) {
+    return false;
+  }
+  data_ = reader.GetString();
+  provenanceMap_.Load(reader);
+  return reader.ok() && provenanceMap_.size() >= data_.size();
+}
+
 static void DumpRange(std::ostream &o, const ProvenanceRange &r) {
   o << "[" << r.start().offset() << ".." << r.Last().offset() << "] ("
     << r.size() << " bytes)";
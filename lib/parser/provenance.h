@@ -22,6 +22,8 @@
 #include "../common/interval.h"
 #include "../common/reference-counted.h"
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
 #include <optional>
@@ -34,6 +36,9 @@
 
 namespace Fortran::parser {
 
+class BinaryReader;
+class BinaryWriter;
+
 // Each character in the contiguous source stream built by the
 // prescanner corresponds to a particular character in a source file,
 // include file, macro expansion, or compiler-inserted padding.
@@ -52,10 +57,28 @@ namespace Fortran::parser {
 // by the upper bits of an offset, but that does not appear to be
 // necessary.)
 
+// Builds configured with FORTRAN_COMPACT_PROVENANCE (see the
+// FLANG_COMPACT_PROVENANCE CMake option) hold provenance offsets and the
+// sizes of provenance ranges in 32 bits, halving the size of each
+// ProvenanceRange in the provenance mappings; such builds cannot compile
+// more than 4GiB of total source, expansion, and insertion text at once.
+// Only the provenance mappings shrink: CharBlock, and so the parse tree's
+// source members, symbols, and the locations of Messages, are unchanged.
+#ifdef FORTRAN_COMPACT_PROVENANCE
+using ProvenanceOffset = std::uint32_t;
+#else
+using ProvenanceOffset = std::size_t;
+#endif
+static constexpr std::size_t maxProvenanceOffset{
+    std::numeric_limits<ProvenanceOffset>::max()};
+
 class Provenance {
 public:
   Provenance() {}
-  Provenance(std::size_t offset) : offset_{offset} { CHECK(offset > 0); }
+  Provenance(std::size_t offset)
+    : offset_{static_cast<ProvenanceOffset>(offset)} {
+    CHECK(offset > 0 && offset <= maxProvenanceOffset);
+  }
   Provenance(const Provenance &that) = default;
   Provenance(Provenance &&that) = default;
   Provenance &operator=(const Provenance &that) = default;
@@ -65,9 +88,9 @@ public:
 
   Provenance operator+(ptrdiff_t n) const {
     CHECK(n > -static_cast<ptrdiff_t>(offset_));
-    return {offset_ + static_cast<std::size_t>(n)};
+    return {offset() + static_cast<std::size_t>(n)};
   }
-  Provenance operator+(std::size_t n) const { return {offset_ + n}; }
+  Provenance operator+(std::size_t n) const { return {offset() + n}; }
   std::size_t operator-(Provenance that) const {
     CHECK(that <= *this);
     return offset_ - that.offset_;
@@ -78,10 +101,10 @@ public:
   bool operator!=(Provenance that) const { return !(*this == that); }
 
 private:
-  std::size_t offset_{0};
+  ProvenanceOffset offset_{0};
 };
 
-using ProvenanceRange = common::Interval<Provenance>;
+using ProvenanceRange = common::Interval<Provenance, ProvenanceOffset>;
 
 // Maps 0-based local offsets in some contiguous range (e.g., a token
 // sequence) to their provenances.  Lookup time is on the order of
@@ -99,6 +122,8 @@ public:
   ProvenanceRange Map(std::size_t at) const;
   void RemoveLastBytes(std::size_t);
   std::ostream &Dump(std::ostream &) const;
+  void Save(BinaryWriter &) const;
+  void Load(BinaryReader &);
 
 private:
   struct ContiguousProvenanceMapping {
@@ -130,6 +155,11 @@ public:
       ProvenanceRange def, ProvenanceRange use, const std::string &expansion);
   ProvenanceRange AddCompilerInsertion(std::string);
 
+  // Discards the most recent origins, and the source files that only they
+  // included, so that size() becomes "bytes", a former value of size().
+  // Their provenances are then allocated anew.
+  void Truncate(std::size_t bytes);
+
   bool IsValid(Provenance at) const { return range_.Contains(at); }
   bool IsValid(ProvenanceRange range) const {
     return range.size() > 0 && range_.Contains(range);
@@ -140,11 +170,18 @@ public:
       Provenance, std::size_t *offset = nullptr) const;
   ProvenanceRange GetContiguousRangeAround(ProvenanceRange) const;
   std::string GetPath(Provenance) const;  // __FILE__
+  std::vector<std::string> GetIncludedFilePaths() const;
   int GetLineNumber(Provenance) const;  // __LINE__
   Provenance CompilerInsertionProvenance(char ch);
   Provenance CompilerInsertionProvenance(const char *, std::size_t);
   std::ostream &Dump(std::ostream &) const;
 
+  // Save() records the origins of all provenances.  Load() reproduces
+  // them in an AllSources instance that has no origins of its own yet,
+  // reopening the source files; it fails if any of them has changed.
+  void Save(BinaryWriter &) const;
+  bool Load(BinaryReader &);
+
 private:
   struct Inclusion {
     const SourceFile &source;
@@ -175,6 +212,7 @@ private:
     ProvenanceRange covers, replaces;
   };
 
+  ProvenanceRange AllocateRange(std::size_t bytes);
   const Origin &MapToOrigin(Provenance) const;
 
   std::vector<Origin> origin_;
@@ -226,6 +264,10 @@ public:
   std::string AcquireData() { return std::move(data_); }
   std::ostream &Dump(std::ostream &) const;
 
+  // Saves the marshaled data and their provenances; see AllSources.
+  void Save(BinaryWriter &) const;
+  bool Load(BinaryReader &);
+
 private:
   common::CountedReference<AllSources> allSources_;
   CharBuffer buffer_;  // before Marshal()
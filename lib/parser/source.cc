@@ -38,14 +38,15 @@ static int openFileDescriptors{0};
 
 SourceFile::~SourceFile() { Close(); }
 
-static std::vector<std::size_t> FindLineStarts(
+template<typename OFFSET>
+static std::vector<OFFSET> FindLineStarts(
     const char *source, std::size_t bytes) {
-  std::vector<std::size_t> result;
+  std::vector<OFFSET> result;
   if (bytes > 0) {
     CHECK(source[bytes - 1] == '\n' && "missing ultimate newline");
     std::size_t at{0};
     do {
-      result.push_back(at);
+      result.push_back(static_cast<OFFSET>(at));
       const void *vp{static_cast<const void *>(&source[at])};
       const void *vnl{std::memchr(vp, '\n', bytes - at)};
       const char *nl{static_cast<const char *>(vnl)};
@@ -56,8 +57,30 @@ static std::vector<std::size_t> FindLineStarts(
   return result;
 }
 
-void SourceFile::RecordLineStarts() {
-  lineStart_ = FindLineStarts(content_, bytes_);
+void SourceFile::RecordLineStarts() const {
+  if (!haveLineStarts_) {
+    if (IsLineStartIndexCompact()) {
+      compactLineStart_ = FindLineStarts<std::uint32_t>(content_, bytes_);
+    } else {
+      lineStart_ = FindLineStarts<std::size_t>(content_, bytes_);
+    }
+    haveLineStarts_ = true;
+  }
+}
+
+std::size_t SourceFile::lines() const {
+  RecordLineStarts();
+  return IsLineStartIndexCompact() ? compactLineStart_.size()
+                                   : lineStart_.size();
+}
+
+std::size_t SourceFile::GetLineStartOffset(int lineNumber) const {
+  RecordLineStarts();
+  if (IsLineStartIndexCompact()) {
+    return compactLineStart_.at(lineNumber - 1);
+  } else {
+    return lineStart_.at(lineNumber - 1);
+  }
 }
 
 // Cut down the contiguous content of a source file to skip
@@ -165,7 +188,6 @@ bool SourceFile::ReadFile(std::string errorPath, std::stringstream *error) {
             std::memchr(static_cast<const void *>(content_), '\r', bytes_) ==
                 nullptr) {
           isMemoryMapped_ = true;
-          RecordLineStarts();
           return true;
         }
         // The file needs to have its line endings normalized to simple
@@ -188,7 +210,6 @@ bool SourceFile::ReadFile(std::string errorPath, std::stringstream *error) {
               CHECK(isNowReadOnly);
               content_ = mutableContent;
               isMemoryMapped_ = true;
-              RecordLineStarts();
               return true;
             }
           }
@@ -231,7 +252,6 @@ bool SourceFile::ReadFile(std::string errorPath, std::stringstream *error) {
     address_ = normalized_.data();
     size_ = normalized_.size();
     IdentifyPayload();
-    RecordLineStarts();
   }
   return true;
 }
@@ -247,6 +267,9 @@ void SourceFile::Close() {
   }
   address_ = content_ = nullptr;
   size_ = bytes_ = 0;
+  haveLineStarts_ = false;
+  compactLineStart_.clear();
+  lineStart_.clear();
   if (fileDescriptor_ > 0) {
     close(fileDescriptor_);
     --openFileDescriptors;
@@ -257,20 +280,30 @@ void SourceFile::Close() {
 
 std::pair<int, int> SourceFile::FindOffsetLineAndColumn(std::size_t at) const {
   CHECK(at < bytes_);
-  if (lineStart_.empty()) {
+  RecordLineStarts();
+  if (IsLineStartIndexCompact()) {
+    return FindLineAndColumn(compactLineStart_, at);
+  } else {
+    return FindLineAndColumn(lineStart_, at);
+  }
+}
+
+template<typename OFFSET>
+std::pair<int, int> SourceFile::FindLineAndColumn(
+    const std::vector<OFFSET> &lineStart, std::size_t at) const {
+  if (lineStart.empty()) {
     return {1, static_cast<int>(at + 1)};
   }
-  std::size_t low{0}, count{lineStart_.size()};
+  std::size_t low{0}, count{lineStart.size()};
   while (count > 1) {
     std::size_t mid{low + (count >> 1)};
-    if (lineStart_[mid] > at) {
+    if (lineStart[mid] > at) {
       count = mid - low;
     } else {
       count -= mid - low;
       low = mid;
     }
   }
-  return {
-      static_cast<int>(low + 1), static_cast<int>(at - lineStart_[low] + 1)};
+  return {static_cast<int>(low + 1), static_cast<int>(at - lineStart[low] + 1)};
 }
 }
@@ -18,8 +18,12 @@
 // Source file content is lightly normalized when the file is read.
 //  - Line ending markers are converted to single newline characters
 //  - A newline character is added to the last line of the file if one is needed
+// The index of line starting offsets is needed only for messages, so it is
+// built on demand, with 32-bit offsets for files smaller than 4GiB.
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -38,20 +42,24 @@ public:
   std::string path() const { return path_; }
   const char *content() const { return content_; }
   std::size_t bytes() const { return bytes_; }
-  std::size_t lines() const { return lineStart_.size(); }
+  std::size_t lines() const;
 
   bool Open(std::string path, std::stringstream *error);
   bool ReadStandardInput(std::stringstream *error);
   void Close();
   std::pair<int, int> FindOffsetLineAndColumn(std::size_t) const;
-  std::size_t GetLineStartOffset(int lineNumber) const {
-    return lineStart_.at(lineNumber - 1);
-  }
+  std::size_t GetLineStartOffset(int lineNumber) const;
 
 private:
   bool ReadFile(std::string errorPath, std::stringstream *error);
   void IdentifyPayload();
-  void RecordLineStarts();
+  void RecordLineStarts() const;
+  bool IsLineStartIndexCompact() const {
+    return bytes_ <= std::numeric_limits<std::uint32_t>::max();
+  }
+  template<typename OFFSET>
+  std::pair<int, int> FindLineAndColumn(
+      const std::vector<OFFSET> &, std::size_t) const;
 
   std::string path_;
   int fileDescriptor_{-1};
@@ -60,7 +68,9 @@ private:
   std::size_t size_{0};
   const char *content_{nullptr};  // usable content
   std::size_t bytes_{0};
-  std::vector<std::size_t> lineStart_;
+  mutable bool haveLineStarts_{false};
+  mutable std::vector<std::uint32_t> compactLineStart_;  // when < 4GiB
+  mutable std::vector<std::size_t> lineStart_;  // otherwise
   std::string normalized_;
 };
 }
@@ -25,7 +25,13 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstddef>
+#include <cstring>
 #include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace Fortran::parser {
 
@@ -35,7 +41,9 @@ public:
       bool capitalize, bool backslashEscapes, preStatementType *preStatement)
     : out_{out}, indentationAmount_{indentationAmount}, encoding_{encoding},
       capitalizeKeywords_{capitalize}, backslashEscapes_{backslashEscapes},
-      preStatement_{preStatement} {}
+      preStatement_{preStatement} {
+    buffer_.reserve(2 * flushThreshold);
+  }
 
   // In nearly all cases, this code avoids defining Boolean-valued Pre()
   // callbacks for the parse tree walking framework in favor of two void
@@ -61,17 +69,18 @@ public:
 
   // Emit simple types as-is.
   void Unparse(const std::string &x) { Put(x); }
-  void Unparse(int x) { Put(std::to_string(x)); }
-  void Unparse(unsigned int x) { Put(std::to_string(x)); }
-  void Unparse(long x) { Put(std::to_string(x)); }
-  void Unparse(unsigned long x) { Put(std::to_string(x)); }
-  void Unparse(long long x) { Put(std::to_string(x)); }
-  void Unparse(unsigned long long x) { Put(std::to_string(x)); }
+  void Unparse(int x) { PutInteger(x); }
+  void Unparse(unsigned int x) { PutInteger(x); }
+  void Unparse(long x) { PutInteger(x); }
+  void Unparse(unsigned long x) { PutInteger(x); }
+  void Unparse(long long x) { PutInteger(x); }
+  void Unparse(unsigned long long x) { PutInteger(x); }
   void Unparse(char x) { Put(x); }
 
   // Statement labels and ends of lines
   template<typename T> void Before(const Statement<T> &x) {
     if (preStatement_) {
+      Flush();
       (*preStatement_)(x.source, out_, indent_);
     }
     Walk(x.label, " ");
@@ -82,10 +91,6 @@ public:
   // ordered to correspond roughly to their order of appearance in
   // the Fortran 2018 standard (and parse-tree.h).
 
-  void Unparse(const Program &x) {  // R501
-    Walk("", x.v, "\n");  // put blank lines between ProgramUnits
-  }
-
   void Unparse(const Name &x) {  // R603
     Put(x.ToString());
   }
@@ -2359,12 +2364,23 @@ public:
   WALK_NESTED_ENUM(OmpCancelType, Type)  // OMP cancel-type
 #undef WALK_NESTED_ENUM
 
-  void Done() const { CHECK(indent_ == 0); }
+  void Done() {
+    CHECK(indent_ == 0);
+    Flush();
+  }
 
 private:
   void Put(char);
-  void Put(const char *);
-  void Put(const std::string &);
+  void Put(const char *, std::size_t);
+  void Put(const char *str) { Put(str, std::strlen(str)); }
+  void Put(const std::string &str) { Put(str.data(), str.size()); }
+  template<typename A> void PutInteger(A x) {
+    FormatDecimal(x, [&](const char *p, std::size_t n) { Put(p, n); });
+  }
+  void Flush() {
+    out_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
   void PutKeywordLetter(char);
   void Word(const char *);
   void Word(const std::string &);
@@ -2436,7 +2452,10 @@ private:
     structureComponents_.clear();
   }
 
+  // Output is accumulated here and written in large blocks.
+  static constexpr std::size_t flushThreshold{1 << 16};
   std::ostream &out_;
+  std::string buffer_;
   int indent_{0};
   const int indentationAmount_{1};
   int column_{1};
@@ -2458,40 +2477,40 @@ void UnparseVisitor::Put(char ch) {
     if (ch == '\n') {
       return;
     }
-    for (int j{0}; j < indent_; ++j) {
-      out_ << ' ';
-    }
+    buffer_.append(indent_, ' ');
     column_ = indent_ + 2;
   } else if (ch == '\n') {
     column_ = 1;
   } else if (++column_ >= maxColumns_) {
-    out_ << "&\n";
-    for (int j{0}; j < indent_; ++j) {
-      out_ << ' ';
-    }
+    buffer_.append("&\n");
+    buffer_.append(indent_, ' ');
     if (openmpDirective_) {
-      out_ << "!$OMP&";
+      buffer_.append("!$OMP&");
       column_ = 8;
     } else {
-      out_ << '&';
+      buffer_ += '&';
       column_ = indent_ + 3;
     }
   }
-  out_ << ch;
+  buffer_ += ch;
   if (openmpDirective_) {
     indent_ = sav;
   }
-}
-
-void UnparseVisitor::Put(const char *str) {
-  for (; *str != '\0'; ++str) {
-    Put(*str);
+  if (ch == '\n' && buffer_.size() >= flushThreshold) {
+    Flush();
   }
 }
 
-void UnparseVisitor::Put(const std::string &str) {
-  for (char ch : str) {
-    Put(ch);
+void UnparseVisitor::Put(const char *str, std::size_t n) {
+  if (column_ > 1 && column_ + n < static_cast<std::size_t>(maxColumns_) &&
+      std::memchr(str, '\n', n) == nullptr) {
+    // The whole run fits on the current line.
+    buffer_.append(str, n);
+    column_ += static_cast<int>(n);
+  } else {
+    for (std::size_t j{0}; j < n; ++j) {
+      Put(str[j]);
+    }
   }
 }
 
@@ -2511,12 +2530,65 @@ void UnparseVisitor::Word(const char *str) {
 
 void UnparseVisitor::Word(const std::string &str) { Word(str.c_str()); }
 
-void Unparse(std::ostream &out, const Program &program, Encoding encoding,
-    bool capitalizeKeywords, bool backslashEscapes,
-    preStatementType *preStatement) {
+// Each program unit is unparsed by a visitor of its own, which starts and
+// finishes at column 1 with no indentation, so that no formatting state
+// carries over from one unit to the next.
+static void UnparseProgramUnit(std::ostream &out,
+    const ProgramUnit &programUnit, Encoding encoding, bool capitalizeKeywords,
+    bool backslashEscapes, preStatementType *preStatement) {
   UnparseVisitor visitor{
       out, 1, encoding, capitalizeKeywords, backslashEscapes, preStatement};
-  Walk(program, visitor);
+  Walk(programUnit, visitor);
   visitor.Done();
 }
+
+void Unparse(std::ostream &out, const Program &program, Encoding encoding,
+    bool capitalizeKeywords, bool backslashEscapes,
+    preStatementType *preStatement) {  // R501
+  for (const ProgramUnit &programUnit : program.v) {
+    UnparseProgramUnit(out, programUnit, encoding, capitalizeKeywords,
+        backslashEscapes, preStatement);
+  }
+}
+
+// The units are dealt out to the threads in turn, so that thread j unparses
+// units j, j+threads, j+2*threads, &c.  No unit's buffer is written to out
+// until all of the threads have finished.
+void UnparseInParallel(std::ostream &out, const Program &program, int threads,
+    Encoding encoding, bool capitalizeKeywords, bool backslashEscapes,
+    const PreStatementFactory *makePreStatement) {
+  std::vector<const ProgramUnit *> units;
+  for (const ProgramUnit &programUnit : program.v) {
+    units.push_back(&programUnit);
+  }
+  std::vector<preStatementType> preStatements;
+  if (makePreStatement != nullptr) {
+    for (std::size_t j{0}; j < units.size(); ++j) {
+      preStatements.emplace_back((*makePreStatement)(*units[j]));
+    }
+  }
+  std::vector<std::string> buffers(units.size());
+  std::size_t workers{std::min<std::size_t>(
+      std::max(threads, 1), std::max<std::size_t>(units.size(), 1))};
+  auto work{[&](std::size_t first) {
+    for (std::size_t j{first}; j < units.size(); j += workers) {
+      std::ostringstream buffer;
+      UnparseProgramUnit(buffer, *units[j], encoding, capitalizeKeywords,
+          backslashEscapes,
+          preStatements.empty() ? nullptr : &preStatements[j]);
+      buffers[j] = buffer.str();
+    }
+  }};
+  std::vector<std::thread> pool;
+  for (std::size_t k{1}; k < workers; ++k) {
+    pool.emplace_back(work, k);
+  }
+  work(0);
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+  for (const std::string &buffer : buffers) {
+    out << buffer;
+  }
+}
 }
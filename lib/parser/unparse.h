@@ -23,6 +23,7 @@
 namespace Fortran::parser {
 
 struct Program;
+struct ProgramUnit;
 
 // A function called before each Statement is unparsed.
 using preStatementType =
@@ -32,6 +33,22 @@ using preStatementType =
 void Unparse(std::ostream &out, const Program &program,
     Encoding encoding = Encoding::UTF8, bool capitalizeKeywords = true,
     bool backslashEscapes = true, preStatementType *preStatement = nullptr);
+
+// Makes the preStatement function for one program unit.
+using PreStatementFactory =
+    std::function<preStatementType(const ProgramUnit &)>;
+
+/// Convert parsed program to out as Fortran, as Unparse() does, but with
+/// its program units unparsed on up to "threads" threads, each unit into
+/// a buffer of its own; the buffers are written to out in program order,
+/// so the output is the same.  Each unit gets its own preStatement
+/// function, if any, from makePreStatement, which is called for all of
+/// the units in order before unparsing begins; a preStatement function
+/// runs on one thread, but must not share state with those of other units.
+void UnparseInParallel(std::ostream &out, const Program &program, int threads,
+    Encoding encoding = Encoding::UTF8, bool capitalizeKeywords = true,
+    bool backslashEscapes = true,
+    const PreStatementFactory *makePreStatement = nullptr);
 }
 
 #endif
@@ -34,6 +34,7 @@ namespace Fortran::parser {
 
 class CookedSource;
 class ParsingLog;
+class ParsingProfile;
 class ParseState;
 
 class Success {};  // for when one must return something that's present
@@ -58,6 +59,12 @@ public:
     return *this;
   }
 
+  ParsingProfile *profile() const { return profile_; }
+  UserState &set_profile(ParsingProfile *profile) {
+    profile_ = profile;
+    return *this;
+  }
+
   bool instrumentedParse() const { return instrumentedParse_; }
   UserState &set_instrumentedParse(bool yes) {
     instrumentedParse_ = yes;
@@ -100,6 +107,7 @@ private:
   std::ostream *debugOutput_{nullptr};
 
   ParsingLog *log_{nullptr};
+  ParsingProfile *profile_{nullptr};
   bool instrumentedParse_{false};
 
   std::unordered_map<Label, int> doLabels_;
@@ -169,6 +169,10 @@ public:
   DoConcurrentLabelEnforce(
       parser::Messages &messages, std::set<parser::Label> &&labels)
     : messages_{messages}, labels_{labels} {}
+  using InterestingTypes = std::tuple<parser::GotoStmt,
+      parser::ComputedGotoStmt, parser::ArithmeticIfStmt, parser::AssignStmt,
+      parser::AssignedGotoStmt, parser::AltReturnSpec, parser::ErrLabel,
+      parser::EndLabel, parser::EorLabel>;
   template<typename T> bool Pre(const T &) { return true; }
   template<typename T> bool Pre(const parser::Statement<T> &statement) {
     currentStatementSourcePosition_ = statement.source;
@@ -218,6 +222,7 @@ private:
 using CS = std::vector<const Symbol *>;
 
 struct GatherSymbols {
+  using InterestingTypes = std::tuple<parser::Name>;
   CS symbols;
   template<typename T> constexpr bool Pre(const T &) { return true; }
   template<typename T> constexpr void Post(const T &) {}
@@ -302,8 +307,6 @@ static CS GatherReferencesFromExpression(const parser::Expr &expression) {
 class FindDoConcurrentLoops {
 public:
   FindDoConcurrentLoops(parser::Messages &messages) : messages_{messages} {}
-  template<typename T> constexpr bool Pre(const T &) { return true; }
-  template<typename T> constexpr void Post(const T &) {}
   void Post(const parser::DoConstruct &doConstruct) {
     auto &doStmt{
         std::get<parser::Statement<parser::NonLabelDoStmt>>(doConstruct.t)};
@@ -502,10 +505,7 @@ private:
   parser::CharBlock currentStatementSourcePosition_;
 };
 
-// DO loops must be canonicalized prior to calling
-void CheckDoConcurrentConstraints(
-    parser::Messages &messages, const parser::Program &program) {
-  FindDoConcurrentLoops findDoConcurrentLoops{messages};
-  Walk(program, findDoConcurrentLoops);
+void DoConcurrentChecker::Post(const parser::DoConstruct &doConstruct) {
+  FindDoConcurrentLoops{messages_}.Post(doConstruct);
 }
 }
@@ -15,14 +15,30 @@
 #ifndef FORTRAN_SEMANTICS_CHECK_DO_CONCURRENT_H_
 #define FORTRAN_SEMANTICS_CHECK_DO_CONCURRENT_H_
 
+#include <tuple>
+
 namespace Fortran::parser {
 class Messages;
+struct DoConstruct;
 struct Program;
 }
 
 namespace Fortran::semantics {
 
-void CheckDoConcurrentConstraints(
-    parser::Messages &messages, const parser::Program &program);
+// A parse tree visitor that enforces the constraints on each DO CONCURRENT
+// construct that it visits; DO loops must be canonicalized beforehand.
+// It can share a traversal with other passes via parser::Walk().
+class DoConcurrentChecker {
+public:
+  explicit DoConcurrentChecker(parser::Messages &messages)
+    : messages_{messages} {}
+  using InterestingTypes = std::tuple<parser::DoConstruct>;
+  template<typename A> bool Pre(const A &) { return true; }
+  template<typename A> void Post(const A &) {}
+  void Post(const parser::DoConstruct &);
+
+private:
+  parser::Messages &messages_;
+};
 }
 #endif  // FORTRAN_SEMANTICS_CHECK_DO_CONCURRENT_H_
@@ -17,11 +17,18 @@
 #include "symbol.h"
 #include "../common/idioms.h"
 #include "../common/indirection.h"
+#include "../parser/characters.h"
 #include "../parser/format-specification.h"
 #include "../parser/parse-tree-visitor.h"
 #include "../parser/parse-tree.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace Fortran::semantics {
 
@@ -30,18 +37,41 @@ using namespace std::string_literals;
 //
 // Dump the Parse Tree hierarchy of any node 'x' of the parse tree.
 //
+// The Text format draws the tree with indentation for people to read.
+// The JSONLines format writes one JSON object per node on a line of its
+// own, with the node's depth in the tree, its name, and its value (if it
+// has one), for consumption by other tools:
+//   {"depth":3,"node":"Name","value":"x"}
+//
+
+enum class DumpTreeFormat { Text, JSONLines };
 
 class ParseTreeDumper {
 public:
-  explicit ParseTreeDumper(std::ostream &out) : out_(out) {}
+  explicit ParseTreeDumper(
+      std::ostream &out, DumpTreeFormat format = DumpTreeFormat::Text)
+    : out_(out), json_{format == DumpTreeFormat::JSONLines} {
+    buffer_.reserve(2 * flushThreshold);
+  }
+  ~ParseTreeDumper() { Flush(); }
 
   constexpr const char *GetNodeName(const char *const &) { return "char *"; }
 #define NODE_NAME(T, N) \
   constexpr const char *GetNodeName(const T &) { return N; }
 #define NODE_ENUM(T, E) \
-  std::string GetNodeName(const T::E &x) { \
-    return #E " = "s + T::EnumToString(x); \
-  }
+  constexpr const char *GetNodeName(const T::E &) { return #E; } \
+  const std::string &GetEnumeratorName(const T::E &x) { \
+    static const std::vector<std::string> names{EnumeratorNames( \
+        T::E##_enumSize, [](int j) { \
+          return T::EnumToString(static_cast<T::E>(j)); \
+        })}; \
+    return names[static_cast<int>(x)]; \
+  } \
+  bool Pre(const T::E &x) { \
+    PutValue(GetNodeName(x), GetEnumeratorName(x)); \
+    return true; \
+  } \
+  void Post(const T::E &) { --indent_; }
 #define NODE(T1, T2) NODE_NAME(T1::T2, #T2)
   NODE_NAME(bool, "bool")
   NODE_NAME(int, "int")
@@ -712,15 +742,23 @@ public:
   NODE(parser, WhereStmt)
   NODE(parser, WriteStmt)
 #undef NODE
+#undef NODE_ENUM
 #undef NODE_NAME
 
   template<typename T> bool Pre(const T &x) {
+    if (json_) {
+      StartJSON(GetNodeName(x));
+      EndJSON();
+      ++indent_;
+      return true;
+    }
     IndentEmptyLine();
     if (UnionTrait<T> || WrapperTrait<T>) {
-      out_ << GetNodeName(x) << " -> ";
+      Put(GetNodeName(x));
+      Put(" -> ");
       emptyline_ = false;
     } else {
-      out_ << GetNodeName(x);
+      Put(GetNodeName(x));
       EndLine();
       ++indent_;
     }
@@ -728,7 +766,9 @@ public:
   }
 
   template<typename T> void Post(const T &x) {
-    if (UnionTrait<T> || WrapperTrait<T>) {
+    if (json_) {
+      --indent_;
+    } else if (UnionTrait<T> || WrapperTrait<T>) {
       if (!emptyline_) {
         EndLine();
       }
@@ -738,14 +778,28 @@ public:
   }
 
   bool PutName(const std::string &name, const semantics::Symbol *symbol) {
-    IndentEmptyLine();
-    if (symbol != nullptr) {
-      out_ << "symbol = " << *symbol;
+    if (json_) {
+      StartJSON("Name");
+      Put(",\"value\":");
+      PutJSONString(name);
+      if (symbol != nullptr) {
+        Put(",\"symbol\":");
+        PutJSONString(SymbolToString(*symbol));
+      }
+      EndJSON();
     } else {
-      out_ << "Name = '" << name << '\'';
+      IndentEmptyLine();
+      if (symbol != nullptr) {
+        Put("symbol = ");
+        Put(SymbolToString(*symbol));
+      } else {
+        Put("Name = '");
+        Put(name);
+        Put('\'');
+      }
+      EndLine();
     }
     ++indent_;
-    EndLine();
     return true;
   }
 
@@ -757,23 +811,11 @@ public:
 
   void Post(const std::string &x) { --indent_; }
 
-  bool Pre(const std::int64_t &x) {
-    IndentEmptyLine();
-    out_ << "int = '" << x << '\'';
-    ++indent_;
-    EndLine();
-    return true;
-  }
+  bool Pre(const std::int64_t &x) { return PutInt(x); }
 
   void Post(const std::int64_t &x) { --indent_; }
 
-  bool Pre(const std::uint64_t &x) {
-    IndentEmptyLine();
-    out_ << "int = '" << x << '\'';
-    ++indent_;
-    EndLine();
-    return true;
-  }
+  bool Pre(const std::uint64_t &x) { return PutInt(x); }
 
   void Post(const std::uint64_t &x) { --indent_; }
 
@@ -806,26 +848,164 @@ public:
 protected:
   void IndentEmptyLine() {
     if (emptyline_ && indent_ > 0) {
-      for (int i{0}; i < indent_; ++i) {
-        out_ << "| ";
+      static constexpr char bars[]{"| | | | | | | | | | | | | | | | "};
+      constexpr int barsLevels{(sizeof bars - 1) / 2};
+      for (int levels{indent_}; levels > 0; levels -= barsLevels) {
+        buffer_.append(bars, 2 * std::min(levels, barsLevels));
       }
       emptyline_ = false;
     }
   }
 
   void EndLine() {
-    out_ << '\n';
+    buffer_ += '\n';
     emptyline_ = true;
+    if (buffer_.size() >= flushThreshold) {
+      Flush();
+    }
   }
 
 private:
+  void Put(char ch) { buffer_ += ch; }
+  void Put(const char *str) { buffer_.append(str, std::strlen(str)); }
+  void Put(const std::string &str) { buffer_.append(str); }
+  template<typename A> void PutInteger(A x) {
+    parser::FormatDecimal(
+        x, [&](const char *p, std::size_t n) { buffer_.append(p, n); });
+  }
+  template<typename A> bool PutInt(A x) {
+    if (json_) {
+      StartJSON("int");
+      Put(",\"value\":");
+      PutInteger(x);
+      EndJSON();
+    } else {
+      IndentEmptyLine();
+      Put("int = '");
+      PutInteger(x);
+      Put('\'');
+      EndLine();
+    }
+    ++indent_;
+    return true;
+  }
+  void PutValue(const char *node, const std::string &value) {
+    if (json_) {
+      StartJSON(node);
+      Put(",\"value\":");
+      PutJSONString(value);
+      EndJSON();
+    } else {
+      IndentEmptyLine();
+      Put(node);
+      Put(" = ");
+      Put(value);
+      EndLine();
+    }
+    ++indent_;
+  }
+
+  void StartJSON(const char *node) {
+    Put("{\"depth\":");
+    PutInteger(indent_);
+    Put(",\"node\":\"");  // node names need no escapes
+    Put(node);
+    Put('"');
+  }
+  void EndJSON() {
+    Put('}');
+    EndLine();
+  }
+  // Bytes that don't begin valid UTF-8 characters are written as the code
+  // points U+0080..U+00FF, so that each line remains valid JSON.
+  void PutJSONString(const std::string &str) {
+    static constexpr char hex[]{"0123456789abcdef"};
+    Put('"');
+    const char *p{str.c_str()}, *limit{p + str.size()};
+    while (p < limit) {
+      auto ch{static_cast<unsigned char>(*p)};
+      int bytes{1};
+      if (ch == '"' || ch == '\\') {
+        Put('\\');
+        Put(*p);
+      } else if (ch < ' ' || ch >= 0x80) {
+        if (int valid{ch < ' ' ? 0 : UTF8CharacterBytes(p, limit)}) {
+          bytes = valid;
+          buffer_.append(p, bytes);
+        } else {
+          Put("\\u00");
+          Put(hex[ch >> 4]);
+          Put(hex[ch & 0xf]);
+        }
+      } else {
+        Put(*p);
+      }
+      p += bytes;
+    }
+    Put('"');
+  }
+
+  // Returns the length of the well-formed UTF-8 character (RFC 3629) at p
+  // that ends by limit, or 0.
+  static int UTF8CharacterBytes(const char *p, const char *limit) {
+    auto byte{[&](int j) {
+      return p + j < limit ? static_cast<unsigned char>(p[j]) : 0;
+    }};
+    auto continues{[&](int j, int low = 0x80, int high = 0xbf) {
+      return byte(j) >= low && byte(j) <= high;
+    }};
+    int lead{byte(0)};
+    if (lead >= 0xc2 && lead <= 0xdf) {
+      return continues(1) ? 2 : 0;
+    } else if (lead >= 0xe0 && lead <= 0xef) {
+      // no overlong forms, and no surrogates
+      bool second{lead == 0xe0 ? continues(1, 0xa0)
+              : lead == 0xed  ? continues(1, 0x80, 0x9f)
+                              : continues(1)};
+      return second && continues(2) ? 3 : 0;
+    } else if (lead >= 0xf0 && lead <= 0xf4) {
+      // no overlong forms, and nothing beyond U+10FFFF
+      bool second{lead == 0xf0 ? continues(1, 0x90)
+              : lead == 0xf4  ? continues(1, 0x80, 0x8f)
+                              : continues(1)};
+      return second && continues(2) && continues(3) ? 4 : 0;
+    } else {
+      return 0;
+    }
+  }
+
+  static std::string SymbolToString(const semantics::Symbol &symbol) {
+    std::stringstream ss;
+    ss << symbol;
+    return ss.str();
+  }
+  template<typename F>
+  static std::vector<std::string> EnumeratorNames(std::size_t n, F toString) {
+    std::vector<std::string> names;
+    for (std::size_t j{0}; j < n; ++j) {
+      names.emplace_back(toString(j));
+    }
+    return names;
+  }
+
+  void Flush() {
+    out_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+
+  // Output is accumulated here and written in large blocks.
+  static constexpr std::size_t flushThreshold{1 << 16};
+  std::string buffer_;
   int indent_{0};
   std::ostream &out_;
+  bool json_{false};
   bool emptyline_{false};
 };
 
-template<typename T> void DumpTree(std::ostream &out, const T &x) {
-  ParseTreeDumper dumper{out};
+template<typename T>
+void DumpTree(std::ostream &out, const T &x,
+    DumpTreeFormat format = DumpTreeFormat::Text) {
+  ParseTreeDumper dumper{out, format};
   parser::Walk(x, dumper);
 }
 }
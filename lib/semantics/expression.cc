@@ -25,7 +25,9 @@
 #include "../parser/parse-tree.h"
 #include <functional>
 #include <iostream>  // TODO pmk remove soon
+#include <map>
 #include <optional>
+#include <vector>
 
 using namespace Fortran::parser::literals;
 
@@ -109,6 +111,17 @@ struct CallAndArguments {
   ActualArguments arguments;
 };
 
+// The values of an array constructor are analyzed before its type is known.
+struct GenericAcValue;
+struct GenericAcImpliedDo {
+  parser::CharBlock name;
+  Expr<SubscriptInteger> lower, upper, stride;
+  std::vector<GenericAcValue> values;
+};
+struct GenericAcValue {
+  std::variant<Expr<SomeType>, GenericAcImpliedDo> u;
+};
+
 // This local class wraps some state and a highly overloaded Analyze()
 // member function that converts parse trees into (usually) generic
 // expressions.
@@ -172,6 +185,12 @@ struct ExprAnalyzer {
   std::optional<Subscript> Analyze(const parser::SectionSubscript &);
   std::vector<Subscript> Analyze(const std::list<parser::SectionSubscript> &);
 
+  std::optional<std::vector<GenericAcValue>> Analyze(
+      const std::list<parser::AcValue> &);
+  std::optional<GenericAcImpliedDo> Analyze(const parser::AcImpliedDo &);
+  std::optional<Expr<SubscriptInteger>> ImpliedDoBound(
+      const parser::ScalarIntExpr &);
+
   std::optional<Expr<SubscriptInteger>> AsSubscript(MaybeExpr &&);
   std::optional<Expr<SubscriptInteger>> GetSubstringBound(
       const std::optional<parser::ScalarIntExpr> &);
@@ -194,6 +213,9 @@ struct ExprAnalyzer {
   }
 
   semantics::SemanticsContext &context;
+  // The kinds of the indices of the enclosing implied DO loops of an
+  // array constructor, by name
+  std::map<parser::CharBlock, int> acImpliedDoKinds;
 };
 
 // This helper template function handles the Scalar<>, Integer<>, and
@@ -555,6 +577,11 @@ static MaybeExpr Designate(DataRef &&dataRef) {
 }
 
 MaybeExpr ExprAnalyzer::Analyze(const parser::Name &n) {
+  if (auto iter{acImpliedDoKinds.find(n.source)};
+      iter != acImpliedDoKinds.end()) {
+    return AsGenericExpr(ConvertToKind<TypeCategory::Integer>(iter->second,
+        AsCategoryExpr(Expr<SubscriptInteger>{ImpliedDoIndex{n.source}})));
+  }
   if (n.symbol == nullptr) {
     Say(n.source,
         "TODO INTERNAL: name '%s' was not resolved to a symbol"_err_en_US,
@@ -855,7 +882,7 @@ MaybeExpr ExprAnalyzer::Analyze(const parser::CharLiteralConstantSubstring &x) {
             StaticDataObject::Pointer staticData{StaticDataObject::Create()};
             staticData->set_alignment(Result::kind)
                 .set_itemBytes(Result::kind)
-                .Push(cp->value);
+                .Push(cp->value());
             Substring substring{
                 std::move(staticData), std::move(*lower), std::move(*upper)};
             return AsGenericExpr(Expr<SomeCharacter>{
@@ -867,8 +894,189 @@ MaybeExpr ExprAnalyzer::Analyze(const parser::CharLiteralConstantSubstring &x) {
   return std::nullopt;
 }
 
-MaybeExpr ExprAnalyzer::Analyze(const parser::ArrayConstructor &) {
-  Say("TODO: ArrayConstructor unimplemented"_en_US);
+std::optional<std::vector<GenericAcValue>> ExprAnalyzer::Analyze(
+    const std::list<parser::AcValue> &acValues) {
+  std::vector<GenericAcValue> result;
+  for (const parser::AcValue &acValue : acValues) {
+    bool ok{std::visit(
+        common::visitors{
+            [&](const parser::AcValue::Triplet &) {
+              Say("TODO: array constructor triplet unimplemented"_en_US);
+              return false;
+            },
+            [&](const common::Indirection<parser::Expr> &expr) {
+              if (MaybeExpr value{Analyze(*expr)}) {
+                result.emplace_back(GenericAcValue{std::move(*value)});
+                return true;
+              }
+              return false;
+            },
+            [&](const common::Indirection<parser::AcImpliedDo> &impliedDo) {
+              if (auto value{Analyze(*impliedDo)}) {
+                result.emplace_back(GenericAcValue{std::move(*value)});
+                return true;
+              }
+              return false;
+            },
+        },
+        acValue.u)};
+    if (!ok) {
+      return std::nullopt;
+    }
+  }
+  return {std::move(result)};
+}
+
+std::optional<Expr<SubscriptInteger>> ExprAnalyzer::ImpliedDoBound(
+    const parser::ScalarIntExpr &bound) {
+  if (MaybeExpr value{Analyze(*bound.thing.thing)}) {
+    if (value->Rank() > 0) {
+      Say("implied DO loop bound must be scalar"_err_en_US);
+    } else if (auto *intExpr{std::get_if<Expr<SomeInteger>>(&value->u)}) {
+      return ConvertToType<SubscriptInteger>(std::move(*intExpr));
+    } else {
+      Say("implied DO loop bound must be INTEGER"_err_en_US);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<GenericAcImpliedDo> ExprAnalyzer::Analyze(
+    const parser::AcImpliedDo &x) {
+  const auto &control{std::get<parser::AcImpliedDoControl>(x.t)};
+  const auto &bounds{
+      std::get<parser::LoopBounds<parser::ScalarIntExpr>>(control.t)};
+  const parser::Name &name{bounds.name.thing.thing};
+  if (acImpliedDoKinds.find(name.source) != acImpliedDoKinds.end()) {
+    Say(name.source,
+        "implied DO index '%s' is the index of an enclosing implied DO loop"_err_en_US,
+        name.ToString().data());
+    return std::nullopt;
+  }
+  auto lower{ImpliedDoBound(bounds.lower)};
+  auto upper{ImpliedDoBound(bounds.upper)};
+  auto stride{bounds.step.has_value()
+          ? ImpliedDoBound(*bounds.step)
+          : std::make_optional(Expr<SubscriptInteger>{1})};
+  if (!lower.has_value() || !upper.has_value() || !stride.has_value()) {
+    return std::nullopt;
+  }
+  // TODO: the kind in the integer-type-spec, if any
+  int kind{context.defaultKinds().GetDefaultKind(TypeCategory::Integer)};
+  if (name.symbol != nullptr) {
+    if (auto type{GetSymbolType(*name.symbol)}) {
+      if (type->category == TypeCategory::Integer) {
+        kind = type->kind;
+      }
+    }
+  }
+  acImpliedDoKinds[name.source] = kind;
+  auto values{Analyze(std::get<std::list<parser::AcValue>>(x.t))};
+  acImpliedDoKinds.erase(name.source);
+  if (!values.has_value()) {
+    return std::nullopt;
+  }
+  return {GenericAcImpliedDo{name.source, std::move(*lower),
+      std::move(*upper), std::move(*stride), std::move(*values)}};
+}
+
+static const Expr<SomeType> *FirstAcValue(
+    const std::vector<GenericAcValue> &values) {
+  for (const GenericAcValue &value : values) {
+    if (const auto *expr{std::get_if<Expr<SomeType>>(&value.u)}) {
+      return expr;
+    }
+    if (const Expr<SomeType> *expr{FirstAcValue(
+            std::get<GenericAcImpliedDo>(value.u).values)}) {
+      return expr;
+    }
+  }
+  return nullptr;
+}
+
+// Converts the values of an array constructor to its type, which they must
+// all share.
+template<typename T>
+bool PushAcValues(ExprAnalyzer &ea, ArrayConstructorValues<T> &result,
+    std::vector<GenericAcValue> &&values) {
+  for (GenericAcValue &value : values) {
+    bool ok{std::visit(
+        common::visitors{
+            [&](Expr<SomeType> &x) {
+              using CategoryExpr = Expr<SomeKind<T::category>>;
+              if (auto *catExpr{std::get_if<CategoryExpr>(&x.u)}) {
+                if (auto *specific{std::get_if<Expr<T>>(&catExpr->u)}) {
+                  result.Push(
+                      CopyableIndirection<Expr<T>>{std::move(*specific)});
+                  return true;
+                }
+              }
+              ea.Say("values of an array constructor must all have the "
+                     "same type and kind"_err_en_US);
+              return false;
+            },
+            [&](GenericAcImpliedDo &x) {
+              ArrayConstructorValues<T> nested;
+              if (!PushAcValues(ea, nested, std::move(x.values))) {
+                return false;
+              }
+              result.Push(ImpliedDo<ArrayConstructorValues<T>,
+                  SubscriptInteger>{x.name, std::move(x.lower),
+                  std::move(x.upper), std::move(x.stride), std::move(nested)});
+              return true;
+            },
+        },
+        value.u)};
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct ArrayConstructorTypeVisitor {
+  using Result = MaybeExpr;
+  static constexpr std::size_t Types{std::tuple_size_v<AllIntrinsicTypes>};
+
+  ArrayConstructorTypeVisitor(ExprAnalyzer &a, const DynamicType &t,
+      std::vector<GenericAcValue> &&x)
+    : ea{a}, type{t}, values{std::move(x)} {}
+
+  template<std::size_t J> Result Test() {
+    using Ty = std::tuple_element_t<J, AllIntrinsicTypes>;
+    if (type == Ty::GetType()) {
+      ArrayConstructor<Ty> result;
+      if (PushAcValues(ea, result, std::move(values))) {
+        return AsMaybeExpr(Expr<Ty>{std::move(result)});
+      }
+    }
+    return std::nullopt;
+  }
+
+  ExprAnalyzer &ea;
+  DynamicType type;
+  std::vector<GenericAcValue> values;
+};
+
+MaybeExpr ExprAnalyzer::Analyze(const parser::ArrayConstructor &array) {
+  const parser::AcSpec &acSpec{array.v};
+  if (acSpec.type.has_value()) {
+    Say("TODO: array constructor with type-spec unimplemented"_en_US);
+    return std::nullopt;
+  }
+  if (auto values{Analyze(acSpec.values)}) {
+    if (const Expr<SomeType> *first{FirstAcValue(*values)}) {
+      if (std::optional<DynamicType> type{first->GetType()}) {
+        if (type->category != TypeCategory::Derived) {
+          return common::SearchDynamicTypes(
+              ArrayConstructorTypeVisitor{*this, *type, std::move(*values)});
+        }
+      }
+      Say("TODO: array constructor of this type unimplemented"_en_US);
+    } else {
+      Say("array constructor without a type-spec must have a value"_err_en_US);
+    }
+  }
   return std::nullopt;
 }
 
@@ -1297,33 +1505,17 @@ evaluate::MaybeExpr AnalyzeExpr(SemanticsContext &context,
   return AnalyzeWrappedExpr(context, expr);
 }
 
-class Mutator {
-public:
-  Mutator(SemanticsContext &context) : context_{context} {}
-
-  template<typename A> bool Pre(A &) { return true /* visit children */; }
-  template<typename A> void Post(A &) {}
-
-  bool Pre(parser::Expr &expr) {
-    if (expr.typedExpr.get() == nullptr) {
-      if (MaybeExpr checked{AnalyzeExpr(context_, expr)}) {
-        checked->AsFortran(std::cout << "checked expression: ") << '\n';
-        expr.typedExpr.reset(
-            new evaluate::GenericExprWrapper{std::move(*checked)});
-      } else {
-        std::cout << "TODO: expression analysis failed for this expression: ";
-        DumpTree(std::cout, expr);
-      }
+bool ExpressionAnalysisMutator::Pre(parser::Expr &expr) {
+  if (expr.typedExpr.get() == nullptr) {
+    if (MaybeExpr checked{AnalyzeExpr(context_, expr)}) {
+      checked->AsFortran(std::cout << "checked expression: ") << '\n';
+      expr.typedExpr.reset(
+          new evaluate::GenericExprWrapper{std::move(*checked)});
+    } else {
+      std::cout << "TODO: expression analysis failed for this expression: ";
+      DumpTree(std::cout, expr);
     }
-    return false;
   }
-
-private:
-  SemanticsContext &context_;
-};
-
-void AnalyzeExpressions(parser::Program &program, SemanticsContext &context) {
-  Mutator mutator{context};
-  parser::Walk(program, mutator);
+  return false;
 }
 }
@@ -52,8 +52,21 @@ std::optional<evaluate::Expr<evaluate::SomeType>> AnalyzeExpr(
     SemanticsContext &,
     const parser::Scalar<parser::Integer<parser::Constant<parser::Expr>>> &);
 
-// Semantic analysis of all expressions in a parse tree, which is
-// decorated with typed representations for top-level expressions.
-void AnalyzeExpressions(parser::Program &, SemanticsContext &);
+// A parse tree mutator that decorates each top-level expression with its
+// typed representation.  It can share a traversal with other passes via
+// parser::Walk().
+class ExpressionAnalysisMutator {
+public:
+  explicit ExpressionAnalysisMutator(SemanticsContext &context)
+    : context_{context} {}
+
+  template<typename A> bool Pre(A &) { return true /* visit children */; }
+  template<typename A> void Post(A &) {}
+
+  bool Pre(parser::Expr &);
+
+private:
+  SemanticsContext &context_;
+};
 }
 #endif  // FORTRAN_SEMANTICS_EXPRESSION_H_
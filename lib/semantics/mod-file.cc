@@ -571,9 +571,15 @@ Scope *ModFileReader::Read(const SourceName &name, Scope *ancestor) {
   ResolveNames(context_, *parseTree);
   const auto &it{parentScope->find(name)};
   if (it == parentScope->end()) {
+    context_.foldCache().Clear();
     return nullptr;
   }
   auto &modSymbol{*it->second};
+  // The module's expressions refer to its parse tree, which is about to be
+  // destroyed, so resolve them now and then forget the folded expressions
+  // that the fold cache keyed by its nodes.
+  ResolveSymbolExprs(context_, *modSymbol.scope());
+  context_.foldCache().Clear();
   // TODO: Preserve the CookedSource rather than acquiring its string.
   modSymbol.scope()->set_chars(std::string{parsing.cooked().AcquireData()});
   modSymbol.set(Symbol::Flag::ModFile);
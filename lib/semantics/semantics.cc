@@ -16,12 +16,14 @@
 #include "canonicalize-do.h"
 #include "check-do-concurrent.h"
 #include "default-kinds.h"
+#include "expression.h"
 #include "mod-file.h"
 #include "resolve-labels.h"
 #include "resolve-names.h"
 #include "rewrite-parse-tree.h"
 #include "scope.h"
 #include "symbol.h"
+#include "../parser/parse-tree-visitor.h"
 #include <ostream>
 
 namespace Fortran::semantics {
@@ -34,7 +36,9 @@ SemanticsContext::SemanticsContext(
   : defaultKinds_{defaultKinds},
     intrinsics_{evaluate::IntrinsicProcTable::Configure(defaultKinds)},
     foldingContext_{evaluate::FoldingContext{
-        parser::ContextualMessages{parser::CharBlock{}, &messages_}}} {}
+        parser::ContextualMessages{parser::CharBlock{}, &messages_}}} {
+  foldingContext_.cache = &foldCache_;
+}
 
 bool SemanticsContext::AnyFatalError() const {
   return !messages_.empty() &&
@@ -42,6 +46,9 @@ bool SemanticsContext::AnyFatalError() const {
 }
 
 bool Semantics::Perform() {
+  // The fold cache is keyed by parse tree nodes; forget those of any
+  // program that was compiled earlier with this context.
+  context_.foldCache().Clear();
   ValidateLabels(context_.messages(), program_);
   if (AnyFatalError()) {
     return false;
@@ -59,18 +66,21 @@ bool Semantics::Perform() {
   if (AnyFatalError()) {
     return false;
   }
-  CheckDoConcurrentConstraints(context_.messages(), program_);
+  DoConcurrentChecker doConcurrentChecker{context_.messages()};
+  // Expression analysis, when requested, shares a traversal with the
+  // DO CONCURRENT checks, so it reports its messages even when those checks
+  // fail; no module file is written if either pass finds an error.
+  if (context_.debugExpressions()) {
+    ExpressionAnalysisMutator expressionAnalysis{context_};
+    parser::Walk(program_, doConcurrentChecker, expressionAnalysis);
+  } else {
+    parser::Walk(program_, doConcurrentChecker);
+  }
   if (AnyFatalError()) {
     return false;
   }
   ModFileWriter writer{context_};
   writer.WriteAll();
-  if (AnyFatalError()) {
-    return false;
-  }
-  if (context_.debugExpressions()) {
-    AnalyzeExpressions(program_, context_);
-  }
   return !AnyFatalError();
 }
 
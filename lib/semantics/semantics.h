@@ -18,6 +18,7 @@
 #include "expression.h"
 #include "scope.h"
 #include "../evaluate/common.h"
+#include "../evaluate/fold.h"
 #include "../evaluate/intrinsics.h"
 #include "../parser/message.h"
 #include <iosfwd>
@@ -46,10 +47,14 @@ public:
   const std::string &moduleDirectory() const { return moduleDirectory_; }
   const bool warningsAreErrors() const { return warningsAreErrors_; }
   const bool debugExpressions() const { return debugExpressions_; }
+  const bool internExpressions() const { return internExpressions_; }
   const evaluate::IntrinsicProcTable &intrinsics() const { return intrinsics_; }
+  ExpressionTable &expressionTable() { return expressionTable_; }
   Scope &globalScope() { return globalScope_; }
   parser::Messages &messages() { return messages_; }
   evaluate::FoldingContext &foldingContext() { return foldingContext_; }
+  evaluate::FoldCache &foldCache() { return foldCache_; }
+  const evaluate::FoldCache &foldCache() const { return foldCache_; }
 
   SemanticsContext &set_searchDirectories(const std::vector<std::string> &x) {
     searchDirectories_ = x;
@@ -67,6 +72,10 @@ public:
     debugExpressions_ = x;
     return *this;
   }
+  SemanticsContext &set_internExpressions(bool x) {
+    internExpressions_ = x;
+    return *this;
+  }
 
   bool AnyFatalError() const;
   template<typename... A> parser::Message &Say(A... args) {
@@ -79,9 +88,12 @@ private:
   std::string moduleDirectory_{"."s};
   bool warningsAreErrors_{false};
   bool debugExpressions_{false};
+  bool internExpressions_{false};
   const evaluate::IntrinsicProcTable intrinsics_;
+  ExpressionTable expressionTable_;  // outlives the symbols that use it
   Scope globalScope_;
   parser::Messages messages_;
+  evaluate::FoldCache foldCache_;
   evaluate::FoldingContext foldingContext_;
 };
 
@@ -20,9 +20,21 @@
 #include "../evaluate/tools.h"
 #include "../evaluate/type.h"
 #include "../parser/characters.h"
+#include <sstream>
 
 namespace Fortran::semantics {
 
+const SomeExpr &ExpressionTable::Intern(SomeExpr &&expr) {
+  CHECK(evaluate::IsConstant(expr));
+  std::stringstream key;
+  expr.AsFortran(key);
+  auto pair{table_.emplace(key.str(), std::move(expr))};
+  if (!pair.second) {
+    ++hits_;
+  }
+  return pair.first->second;
+}
+
 LazyExpr::LazyExpr(SomeExpr &&expr) : u_{CopyableExprPtr{std::move(expr)}} {}
 
 MaybeExpr LazyExpr::Get() { return static_cast<const LazyExpr *>(this)->Get(); }
@@ -30,23 +42,56 @@ MaybeExpr LazyExpr::Get() { return static_cast<const LazyExpr *>(this)->Get(); }
 const MaybeExpr LazyExpr::Get() const {
   if (auto *ptr{std::get_if<CopyableExprPtr>(&u_)}) {
     return **ptr;
+  } else if (const SomeExpr * interned{GetInterned()}) {
+    return *interned;
   } else {
     return std::nullopt;
   }
 }
 
+const SomeExpr *LazyExpr::GetInterned() const {
+  if (auto *ptr{std::get_if<InternedExprPtr>(&u_)}) {
+    return *ptr;
+  } else {
+    return nullptr;
+  }
+}
+
+// Clones of a LazyExpr share its parse tree expression (e.g., the bounds
+// of each entity in "real, dimension(n) :: a, b, c"), so the fold cache in
+// the folding context, when present, saves their repeated analysis.
+static MaybeExpr AnalyzeAndFold(
+    SemanticsContext &context, const parser::Expr &expr) {
+  evaluate::FoldingContext &foldingContext{context.foldingContext()};
+  evaluate::FoldCache *cache{foldingContext.cache};
+  if (cache != nullptr) {
+    if (const SomeExpr *folded{cache->Find(foldingContext, &expr)}) {
+      return *folded;
+    }
+  }
+  MaybeExpr result{evaluate::Fold(foldingContext, AnalyzeExpr(context, expr))};
+  if (cache != nullptr && result.has_value()) {
+    return cache->Insert(foldingContext, &expr, std::move(*result));
+  }
+  return result;
+}
+
 bool LazyExpr::Resolve(SemanticsContext &context) {
   if (auto *expr{std::get_if<const parser::Expr *>(&u_)}) {
     if (!*expr) {
       u_ = ErrorInExpr{};
-    } else if (MaybeExpr maybeExpr{AnalyzeExpr(context, **expr)}) {
-      u_ = CopyableExprPtr{
-          evaluate::Fold(context.foldingContext(), std::move(*maybeExpr))};
+    } else if (MaybeExpr folded{AnalyzeAndFold(context, **expr)}) {
+      if (context.internExpressions() && evaluate::IsConstant(*folded)) {
+        u_ = &context.expressionTable().Intern(std::move(*folded));
+      } else {
+        u_ = CopyableExprPtr{std::move(*folded)};
+      }
     } else {
       u_ = ErrorInExpr{};
     }
   }
-  return std::holds_alternative<CopyableExprPtr>(u_);
+  return std::holds_alternative<CopyableExprPtr>(u_) ||
+      std::holds_alternative<InternedExprPtr>(u_);
 }
 
 std::ostream &operator<<(std::ostream &o, const LazyExpr &x) {
@@ -55,6 +100,7 @@ std::ostream &operator<<(std::ostream &o, const LazyExpr &x) {
           [&](const parser::Expr *x) { o << (x ? "UNRESOLVED" : "EMPTY"); },
           [&](const LazyExpr::ErrorInExpr &) { o << "ERROR"; },
           [&](const LazyExpr::CopyableExprPtr &x) { x->AsFortran(o); },
+          [&](const LazyExpr::InternedExprPtr &x) { x->AsFortran(o); },
       },
       x.u_);
   return o;
@@ -248,11 +294,11 @@ class ExprResolver {
 public:
   ExprResolver(SemanticsContext &context) : context_{context} {}
   void Resolve() { Resolve(context_.globalScope()); }
+  void Resolve(Scope &);
 
 private:
   SemanticsContext &context_;
 
-  void Resolve(Scope &);
   void Resolve(Symbol &);
   void Resolve(Bound &bound) { bound.Resolve(context_); }
   void Resolve(LazyExpr &expr) { expr.Resolve(context_); }
@@ -293,4 +339,7 @@ void ExprResolver::Resolve(Symbol &symbol) {
 void ResolveSymbolExprs(SemanticsContext &context) {
   ExprResolver(context).Resolve();
 }
+void ResolveSymbolExprs(SemanticsContext &context, Scope &scope) {
+  ExprResolver(context).Resolve(scope);
+}
 }
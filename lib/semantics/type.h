@@ -47,12 +47,32 @@ using TypeCategory = common::TypeCategory;
 using SomeExpr = evaluate::Expr<evaluate::SomeType>;
 using MaybeExpr = std::optional<SomeExpr>;
 
+// A table of interned constant expressions.  Each distinct constant
+// expression is stored once, so the many bound, length, and KIND parameter
+// expressions of a heavily parameterized program share their storage.
+// Interned expressions are immutable and live as long as the table.
+class ExpressionTable {
+public:
+  // Returns the interned copy of a constant expression.
+  const SomeExpr &Intern(SomeExpr &&);
+  std::size_t size() const { return table_.size(); }
+  std::size_t hits() const { return hits_; }
+
+private:
+  // Keyed by the Fortran representation of the expression, which is
+  // exact for constants of intrinsic types.
+  std::unordered_map<std::string, const SomeExpr> table_;
+  std::size_t hits_{0};
+};
+
 // An expression that starts out as a parser::Expr and gets resolved to
 // a MaybeExpr. Resolve should not be called until after names are resolved.
 // An unresolved LazyExpr should not be used after the parse tree is deleted.
+// When the SemanticsContext interns expressions, a LazyExpr that resolves
+// to a constant refers to its interned copy.
 class LazyExpr {
 public:
-  LazyExpr() : u_{nullptr} {}
+  LazyExpr() : u_{static_cast<const parser::Expr *>(nullptr)} {}
   LazyExpr(const parser::Expr &expr) : u_{&expr} {}
   LazyExpr(SomeExpr &&);
   LazyExpr(LazyExpr &&) = default;
@@ -61,11 +81,16 @@ public:
   const MaybeExpr Get() const;
   MaybeExpr Get();
   bool Resolve(SemanticsContext &);
+  // The interned expression, if any
+  const SomeExpr *GetInterned() const;
 
 private:
   using CopyableExprPtr = common::Indirection<SomeExpr, true>;
+  using InternedExprPtr = const SomeExpr *;  // owned by an ExpressionTable
   struct ErrorInExpr {};  // marks an expr with an error in evaluation
-  std::variant<const parser::Expr *, CopyableExprPtr, ErrorInExpr> u_;
+  std::variant<const parser::Expr *, CopyableExprPtr, InternedExprPtr,
+      ErrorInExpr>
+      u_;
 
   LazyExpr(const LazyExpr &) = default;
   friend std::ostream &operator<<(std::ostream &, const LazyExpr &);
@@ -319,6 +344,7 @@ private:
 
 // Resolve expressions in symbols.
 void ResolveSymbolExprs(SemanticsContext &);
+void ResolveSymbolExprs(SemanticsContext &, Scope &);
 }
 
 #endif  // FORTRAN_SEMANTICS_TYPE_H_
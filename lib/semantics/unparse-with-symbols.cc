@@ -32,6 +32,7 @@ public:
   // Write out symbols referenced at this statement.
   void PrintSymbols(const parser::CharBlock &, std::ostream &, int);
 
+  using InterestingTypes = std::tuple<parser::Name>;
   template<typename T> bool Pre(const T &) { return true; }
   template<typename T> void Post(const T &) {}
   template<typename T> bool Pre(const parser::Statement<T> &stmt) {
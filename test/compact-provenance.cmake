@@ -0,0 +1,33 @@
+# Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Configures and builds f18 with FLANG_COMPACT_PROVENANCE in BINARY_DIR from
+# the sources in SOURCE_DIR, then runs the semantics tests with it.
+# Usage: cmake -DSOURCE_DIR=... -DBINARY_DIR=... -P compact-provenance.cmake
+
+function(run step directory)
+  execute_process(COMMAND ${ARGN} WORKING_DIRECTORY ${directory}
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "compact provenance ${step} step failed")
+  endif()
+endfunction()
+
+file(MAKE_DIRECTORY ${BINARY_DIR})
+run(configure ${BINARY_DIR} ${CMAKE_COMMAND} ${SOURCE_DIR}
+  -DFLANG_COMPACT_PROVENANCE=ON
+  -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+  -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE})
+run(build ${BINARY_DIR} ${CMAKE_COMMAND} --build ${BINARY_DIR} --target f18)
+run(test ${BINARY_DIR}/test/semantics ${CMAKE_CTEST_COMMAND} --output-on-failure)
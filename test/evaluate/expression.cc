@@ -50,5 +50,85 @@ int main() {
   a = b;
   MATCH("2_4", AsFortran(a));
   MATCH("2_4", AsFortran(b));
+
+  // [integer(4)::7,(10*j,j=1,3)] folds to a rank-1 constant
+  using DefaultInteger = DefaultIntegerExpr::Result;
+  Fortran::parser::CharBlock j{"j"};
+  ArrayConstructorValues<DefaultInteger> body;
+  body.Push(DefaultIntegerExpr{10} *
+      ConvertToType<DefaultInteger>(
+          Expr<SomeInteger>{Expr<SubscriptInteger>{ImpliedDoIndex{j}}}));
+  ArrayConstructor<DefaultInteger> array;
+  array.Push(DefaultIntegerExpr{7});
+  array.Push(ArrayConstructorValue<DefaultInteger>::ImpliedDo<DefaultInteger>{
+      j, DefaultIntegerExpr{1}, DefaultIntegerExpr{3}, DefaultIntegerExpr{1},
+      std::move(body)});
+  DefaultIntegerExpr folded{Fold(context, DefaultIntegerExpr{array})};
+  MATCH("[7_4,10_4,20_4,30_4]", AsFortran(folded));
+  TEST(folded.Rank() == 1);
+  TEST(!GetScalarConstantValue(folded).has_value());
+  if (const auto *c{std::get_if<Constant<DefaultInteger>>(&folded.u)}) {
+    MATCH(4, c->size());
+    MATCH(20, c->At({3}).ToInt64());
+    Constant<DefaultInteger> matrix{
+        std::vector<Scalar<DefaultInteger>>(
+            c->values.begin(), c->values.end()),
+        {2, 2}};
+    MATCH(2, matrix.Rank());
+    MATCH(10, matrix.At({2, 1}).ToInt64());
+    MATCH(20, matrix.At({1, 2}).ToInt64());
+    MATCH("reshape([7_4,10_4,20_4,30_4],shape=[2_8,2_8])", AsFortran(matrix));
+  } else {
+    TEST(false);
+  }
+
+  // Elementwise folding of array operands broadcasts scalars
+  DefaultIntegerExpr sum{
+      Fold(context, DefaultIntegerExpr{folded} + DefaultIntegerExpr{1})};
+  MATCH("[8_4,11_4,21_4,31_4]", AsFortran(sum));
+  DefaultIntegerExpr product{
+      Fold(context, DefaultIntegerExpr{folded} * DefaultIntegerExpr{sum})};
+  MATCH("[56_4,110_4,420_4,930_4]", AsFortran(product));
+  Fortran::parser::Messages buffer;
+  Fortran::parser::ContextualMessages errors{src, &buffer};
+  FoldingContext errorContext{errors};
+  DefaultIntegerExpr nonconformable{Fold(errorContext,
+      DefaultIntegerExpr{folded} +
+          DefaultIntegerExpr{Constant<DefaultInteger>{
+              std::vector<Scalar<DefaultInteger>>(3), {3}}})};
+  TEST(nonconformable.Rank() == 1);
+  TEST(!std::holds_alternative<Constant<DefaultInteger>>(nonconformable.u));
+  TEST(buffer.AnyFatalError());
+
+  // .NOT. folds to the complement of its operand, elementwise
+  using DefaultLogical = Type<TypeCategory::Logical, 4>;
+  using DefaultLogicalExpr = Expr<DefaultLogical>;
+  DefaultLogicalExpr notTrue{Fold(context,
+      DefaultLogicalExpr{Not<4>{DefaultLogicalExpr{
+          Constant<DefaultLogical>{Scalar<DefaultLogical>{true}}}}})};
+  MATCH(".false._4", AsFortran(notTrue));
+  DefaultLogicalExpr notArray{Fold(context,
+      DefaultLogicalExpr{Not<4>{DefaultLogicalExpr{Constant<DefaultLogical>{
+          std::vector<Scalar<DefaultLogical>>{true, false}, {2}}}}})};
+  MATCH("[.false._4,.true._4]", AsFortran(notArray));
+
+  // Scalar and one-element array constants each hold a single element
+  DefaultIntegerExpr scalarSum{Fold(context,
+      DefaultIntegerExpr{Constant<DefaultInteger>{Scalar<DefaultInteger>{1}}} +
+          DefaultIntegerExpr{
+              Constant<DefaultInteger>{Scalar<DefaultInteger>{2}}})};
+  MATCH("3_4", AsFortran(scalarSum));
+  if (const auto *c{std::get_if<Constant<DefaultInteger>>(&scalarSum.u)}) {
+    MATCH(0, c->Rank());
+    MATCH(1, c->size());
+  } else {
+    TEST(false);
+  }
+  Constant<DefaultInteger> single{
+      std::vector<Scalar<DefaultInteger>>{Scalar<DefaultInteger>{5}}, {1}};
+  MATCH(1, single.Rank());
+  MATCH(1, single.size());
+  MATCH(5, single.At({1}).ToInt64());
+  MATCH("[5_4]", AsFortran(single));
   return testing::Complete();
 }
@@ -14,9 +14,11 @@
 
 #include "../../lib/evaluate/integer.h"
 #include "testing.h"
+#include <chrono>
 #include <cstdio>
 #include <string>
 
+using Fortran::evaluate::IsHostLittleEndian;
 using Fortran::evaluate::Ordering;
 using Fortran::evaluate::value::Integer;
 
@@ -255,7 +257,123 @@ template<int BITS, typename INT = Integer<BITS>> void exhaustiveTesting() {
   }
 }
 
-int main() {
+// Checks the native host arithmetic of a default Integer<BITS> against the
+// part-by-part algorithms of an otherwise identical Integer whose parts
+// are stored in the opposite order.
+template<int BITS, typename FAST = Integer<BITS>,
+    typename SLOW = Integer<BITS, !IsHostLittleEndian>>
+void differentialTesting(std::uint64_t x, std::uint64_t y) {
+  char desc[64];
+  std::snprintf(desc, sizeof desc, "BITS=%d, x=0x%llx, y=0x%llx", BITS,
+      static_cast<unsigned long long>(x), static_cast<unsigned long long>(y));
+  FAST fx{x}, fy{y};
+  SLOW sx{x}, sy{y};
+  for (bool carryIn : {false, true}) {
+    auto fsum{fx.AddUnsigned(fy, carryIn)};
+    auto ssum{sx.AddUnsigned(sy, carryIn)};
+    MATCH(ssum.value.ToUInt64(), fsum.value.ToUInt64())("%s", desc);
+    MATCH(ssum.carry, fsum.carry)("%s", desc);
+  }
+  auto fdiff{fx.SubtractSigned(fy)};
+  auto sdiff{sx.SubtractSigned(sy)};
+  MATCH(sdiff.value.ToUInt64(), fdiff.value.ToUInt64())("%s", desc);
+  MATCH(sdiff.overflow, fdiff.overflow)("%s", desc);
+  auto fproduct{fx.MultiplyUnsigned(fy)};
+  auto sproduct{sx.MultiplyUnsigned(sy)};
+  MATCH(sproduct.upper.ToUInt64(), fproduct.upper.ToUInt64())("%s", desc);
+  MATCH(sproduct.lower.ToUInt64(), fproduct.lower.ToUInt64())("%s", desc);
+  fproduct = fx.MultiplySigned(fy);
+  sproduct = sx.MultiplySigned(sy);
+  MATCH(sproduct.upper.ToUInt64(), fproduct.upper.ToUInt64())("%s", desc);
+  MATCH(sproduct.lower.ToUInt64(), fproduct.lower.ToUInt64())("%s", desc);
+  MATCH(sproduct.SignedMultiplicationOverflowed(),
+      fproduct.SignedMultiplicationOverflowed())
+  ("%s", desc);
+  auto fquot{fx.DivideUnsigned(fy)};
+  auto squot{sx.DivideUnsigned(sy)};
+  MATCH(squot.quotient.ToUInt64(), fquot.quotient.ToUInt64())("%s", desc);
+  MATCH(squot.remainder.ToUInt64(), fquot.remainder.ToUInt64())("%s", desc);
+  MATCH(squot.divisionByZero, fquot.divisionByZero)("%s", desc);
+  fquot = fx.DivideSigned(fy);
+  squot = sx.DivideSigned(sy);
+  MATCH(squot.quotient.ToUInt64(), fquot.quotient.ToUInt64())("%s", desc);
+  MATCH(squot.remainder.ToUInt64(), fquot.remainder.ToUInt64())("%s", desc);
+  MATCH(squot.divisionByZero, fquot.divisionByZero)("%s", desc);
+  MATCH(squot.overflow, fquot.overflow)("%s", desc);
+  auto fpow{fx.Power(FAST{y % (BITS + 2)})};
+  auto spow{sx.Power(SLOW{y % (BITS + 2)})};
+  MATCH(spow.power.ToUInt64(), fpow.power.ToUInt64())("%s", desc);
+  MATCH(spow.overflow, fpow.overflow)("%s", desc);
+}
+
+// Exhaustive over all pairs of values when BITS is small; otherwise, all
+// pairs of interesting edge values and a deterministic pseudo-random sample.
+template<int BITS> void differentialTesting() {
+  if constexpr (BITS <= 8) {
+    for (std::uint64_t x{0}; x < std::uint64_t{1} << BITS; ++x) {
+      for (std::uint64_t y{0}; y < std::uint64_t{1} << BITS; ++y) {
+        differentialTesting<BITS>(x, y);
+      }
+    }
+  } else {
+    std::uint64_t edges[4 * BITS + 4];
+    int n{0};
+    for (int j{0}; j < BITS; ++j) {
+      std::uint64_t bit{std::uint64_t{1} << j};
+      edges[n++] = bit;
+      edges[n++] = bit - 1;
+      edges[n++] = bit + 1;
+      edges[n++] = -bit;
+    }
+    edges[n++] = ~std::uint64_t{0};
+    for (int j{0}; j < n; ++j) {
+      for (int k{0}; k < n; ++k) {
+        differentialTesting<BITS>(edges[j], edges[k]);
+      }
+    }
+    std::uint64_t seed{0x243f6a8885a308d3};
+    for (int j{0}; j < 100000; ++j) {
+      seed = seed * 6364136223846793005 + 1442695040888963407;
+      std::uint64_t x{seed >> (j % 64)};
+      seed = seed * 6364136223846793005 + 1442695040888963407;
+      std::uint64_t y{seed >> (j / 64 % 64)};
+      differentialTesting<BITS>(x, y);
+    }
+  }
+}
+
+// Prints timings of the native and part-by-part forms of the arithmetic
+// used by constant folding; run "integer-test -benchmark".
+template<int BITS, typename INT> void benchmark(const char *what) {
+  constexpr int iterations{1000000};
+  auto start{std::chrono::steady_clock::now()};
+  INT accumulator{1};
+  std::uint64_t seed{1};
+  for (int j{0}; j < iterations; ++j) {
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    INT x{seed >> 11}, y{(seed >> 40) | 1};
+    accumulator = accumulator.AddUnsigned(x.MultiplySigned(y).lower).value;
+    accumulator = accumulator.IEOR(x.DivideSigned(y).quotient);
+  }
+  std::chrono::duration<double> seconds{
+      std::chrono::steady_clock::now() - start};
+  std::printf("%d-bit %s: %.3fs (0x%llx)\n", BITS, what, seconds.count(),
+      static_cast<unsigned long long>(accumulator.ToUInt64()));
+}
+
+template<int BITS> void benchmark() {
+  benchmark<BITS, Integer<BITS>>("native");
+  benchmark<BITS, Integer<BITS, !IsHostLittleEndian>>("by parts");
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && std::string{argv[1]} == "-benchmark") {
+    benchmark<8>();
+    benchmark<16>();
+    benchmark<32>();
+    benchmark<64>();
+    return 0;
+  }
   TEST(Reverse(Ordering::Less) == Ordering::Greater);
   TEST(Reverse(Ordering::Greater) == Ordering::Less);
   TEST(Reverse(Ordering::Equal) == Ordering::Equal);
@@ -275,5 +393,9 @@ int main() {
   exhaustiveTesting<9, Integer<9, true, 2, std::uint8_t, std::uint16_t>>();
   exhaustiveTesting<9, Integer<9, true, 8, std::uint8_t, std::uint16_t>>();
   exhaustiveTesting<9, Integer<9, false, 8, std::uint8_t, std::uint16_t>>();
+  differentialTesting<8>();
+  differentialTesting<16>();
+  differentialTesting<32>();
+  differentialTesting<64>();
   return testing::Complete();
 }
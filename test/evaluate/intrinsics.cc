@@ -15,12 +15,18 @@
 #include "../../lib/evaluate/intrinsics.h"
 #include "testing.h"
 #include "../../lib/evaluate/expression.h"
+#include "../../lib/evaluate/fold.h"
 #include "../../lib/evaluate/tools.h"
 #include "../../lib/parser/provenance.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <initializer_list>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace Fortran::evaluate {
 
@@ -53,6 +59,12 @@ private:
   std::map<std::string, std::size_t> offsets_;
 };
 
+template<typename A> std::string AsFortran(const A &x) {
+  std::stringstream ss;
+  x.AsFortran(ss);
+  return ss.str();
+}
+
 template<typename A> auto Const(A &&x) -> Constant<TypeOf<A>> {
   return Constant<TypeOf<A>>{std::move(x)};
 }
@@ -126,6 +138,28 @@ struct TestCall {
     strings.Emit(std::cout, buffer);
   }
 
+  // Resolves the call to a reference to the specific intrinsic.
+  template<typename T> Expr<T> DoResolve() {
+    Marshal();
+    CallCharacteristics call{strings(name)};
+    auto messages{strings.Messages(buffer)};
+    std::optional<SpecificCall> si{table.Probe(call, args, &messages)};
+    TEST(si.has_value());
+    TEST(buffer.empty());
+    strings.Emit(std::cout, buffer);
+    if (!si.has_value()) {
+      return Expr<T>{Scalar<T>{}};
+    }
+    return Expr<T>{
+        FunctionRef<T>{ProcedureDesignator{std::move(si->specificIntrinsic)},
+            std::move(si->arguments)}};
+  }
+
+  // Resolves the call and folds the reference.
+  template<typename T> Expr<T> DoFold(FoldingContext &context) {
+    return Fold(context, DoResolve<T>());
+  }
+
   const IntrinsicProcTable &table;
   CookedStrings strings;
   parser::Messages buffer;
@@ -208,11 +242,174 @@ void TestIntrinsics() {
   amin0Call.DoCall(Real4::dynamicType);
   amin1Call.DoCall();
 
+  TestCall{table, "huge"}
+      .Push(Const(Scalar<Real8>{}))
+      .DoCall(Real8::dynamicType);
+  TestCall{table, "kind"}
+      .Push(Const(Scalar<Char>{}))
+      .DoCall(Int4::dynamicType);
+  TestCall{table, "size"}
+      .Push(Const(Scalar<Int4>{}))
+      .DoCall(Int8::dynamicType);
+
+  // Repeated calls are resolved from a memo, which must distinguish KIND=
+  for (int j{0}; j < 2; ++j) {
+    TestCall{table, "int"}
+        .Push(Const(Scalar<Real4>{}), Named("kind", Const(Scalar<Int4>{8})))
+        .DoCall(Int8::dynamicType);
+    TestCall{table, "int"}
+        .Push(Const(Scalar<Real4>{}), Named("kind", Const(Scalar<Int4>{1})))
+        .DoCall(Int1::dynamicType);
+  }
+
   // TODO: test other intrinsics
 }
+
+// Folding of references to intrinsic functions
+void TestIntrinsicFolding() {
+  semantics::IntrinsicTypeDefaultKinds defaults;
+  IntrinsicProcTable table{IntrinsicProcTable::Configure(defaults)};
+  parser::CharBlock src;
+  parser::ContextualMessages messages{src, nullptr};
+  FoldingContext context{messages};
+
+  using Int1 = Type<TypeCategory::Integer, 1>;
+  using Int4 = Type<TypeCategory::Integer, 4>;
+  using Int8 = Type<TypeCategory::Integer, 8>;
+  using Real4 = Type<TypeCategory::Real, 4>;
+  using Char = Type<TypeCategory::Character, 1>;
+
+  auto fold{[&](TestCall &call, auto type) {
+    using T = decltype(type);
+    return AsFortran(call.DoFold<T>(context));
+  }};
+  MATCH("2_4",
+      fold(TestCall{table, "selected_int_kind"}.Push(Const(Scalar<Int4>{4})),
+          Int4{}));
+  MATCH("8_4",
+      fold(TestCall{table, "selected_int_kind"}.Push(Const(Scalar<Int8>{10})),
+          Int4{}));
+  MATCH("-1_4",
+      fold(TestCall{table, "selected_int_kind"}.Push(Const(Scalar<Int4>{39})),
+          Int4{}));
+  MATCH("127_1",
+      fold(TestCall{table, "huge"}.Push(Const(Scalar<Int1>{})), Int1{}));
+  MATCH("3.4028235e38_4",
+      fold(TestCall{table, "huge"}.Push(Const(Scalar<Real4>{})), Real4{}));
+  MATCH("8_4",
+      fold(TestCall{table, "kind"}.Push(Const(Scalar<Int8>{})), Int4{}));
+  MATCH("1_4",
+      fold(TestCall{table, "kind"}.Push(Const(Scalar<Char>{})), Int4{}));
+  MATCH("3_4",
+      fold(TestCall{table, "len"}.Push(Const(Scalar<Char>{"abc"})), Int4{}));
+  MATCH("7_4",
+      fold(TestCall{table, "abs"}.Push(Const(Scalar<Int4>{-7})), Int4{}));
+  MATCH("9_4",
+      fold(TestCall{table, "max"}.Push(Const(Scalar<Int4>{3}),
+               Const(Scalar<Int4>{9}), Const(Scalar<Int4>{-2})),
+          Int4{}));
+  MATCH("-2_4",
+      fold(TestCall{table, "min0"}.Push(Const(Scalar<Int4>{3}),
+               Const(Scalar<Int4>{9}), Const(Scalar<Int4>{-2})),
+          Int4{}));
+  MATCH("4_4",
+      fold(TestCall{table, "iand"}.Push(
+               Const(Scalar<Int4>{12}), Const(Scalar<Int4>{6})),
+          Int4{}));
+  MATCH("-4_8",
+      fold(TestCall{table, "ishft"}.Push(
+               Const(Scalar<Int8>{-1}), Const(Scalar<Int4>{2})),
+          Int8{}));
+  MATCH("1073741823_4",
+      fold(TestCall{table, "ishft"}.Push(
+               Const(Scalar<Int4>{-1}), Const(Scalar<Int1>{-2})),
+          Int4{}));
+  // SHIFT= is out of range before it would be converted to INTEGER(1)
+  MATCH("ishft(1_1,264_4)",
+      fold(TestCall{table, "ishft"}.Push(
+               Const(Scalar<Int1>{1}), Const(Scalar<Int4>{264})),
+          Int1{}));
+  MATCH("-128_1",
+      fold(TestCall{table, "ishft"}.Push(
+               Const(Scalar<Int1>{1}), Const(Scalar<Int8>{7})),
+          Int1{}));
+  for (int j{0}; j < 2; ++j) {  // the second call reuses the first's resolution
+    MATCH("12_4",
+        fold(TestCall{table, "ishft"}.Push(
+                 Named("shift", Const(Scalar<Int4>{2})),
+                 Named("i", Const(Scalar<Int4>{3}))),
+            Int4{}));
+  }
+  Constant<Int4> matrix{std::vector<Scalar<Int4>>(6), ConstantSubscripts{2, 3}};
+  MATCH("6_8",
+      fold(TestCall{table, "size"}.Push(Constant<Int4>{matrix}), Int8{}));
+  MATCH("3_8",
+      fold(TestCall{table, "size"}.Push(Constant<Int4>{matrix},
+               Named("dim", Const(Scalar<Int4>{2})),
+               Named("kind", Const(Scalar<Int4>{8}))),
+          Int8{}));
+  MATCH("[1_4,2_4,3_4]",
+      fold(TestCall{table, "abs"}.Push(Constant<Int4>{
+               std::vector<Scalar<Int4>>{-1, 2, -3}, ConstantSubscripts{3}}),
+          Int4{}));
+}
+
+// Prints the time taken to fold the kind selectors of a module with
+// thousands of declarations like INTEGER(SELECTED_INT_KIND(R)) and
+// INTEGER(KIND(HUGE(0_8))); run "intrinsics-test -benchmark".  The
+// references are resolved beforehand, so that only folding is timed.
+void BenchmarkIntrinsicFolding() {
+  semantics::IntrinsicTypeDefaultKinds defaults;
+  IntrinsicProcTable table{IntrinsicProcTable::Configure(defaults)};
+  parser::CharBlock src;
+  parser::ContextualMessages messages{src, nullptr};
+  FoldingContext context{messages};
+
+  using Int2 = Type<TypeCategory::Integer, 2>;
+  using Int4 = Type<TypeCategory::Integer, 4>;
+  using Int8 = Type<TypeCategory::Integer, 8>;
+
+  constexpr int declarations{10000};
+  std::vector<Expr<Int4>> selectors;
+  for (int j{0}; j < declarations; ++j) {
+    selectors.emplace_back(TestCall{table, "selected_int_kind"}
+                               .Push(Const(Scalar<Int4>{j % 40}))
+                               .DoResolve<Int4>());
+    selectors.emplace_back(
+        TestCall{table, "kind"}
+            .Push(TestCall{table, "huge"}
+                      .Push(Const(Scalar<Int8>{}))
+                      .DoResolve<Int8>())
+            .DoResolve<Int4>());
+    selectors.emplace_back(
+        TestCall{table, "max"}
+            .Push(TestCall{table, "kind"}
+                      .Push(Const(Scalar<Int2>{}))
+                      .DoResolve<Int4>(),
+                Const(Scalar<Int4>{j % 8}))
+            .DoResolve<Int4>());
+  }
+  auto start{std::chrono::steady_clock::now()};
+  std::int64_t kinds{0};
+  for (Expr<Int4> &selector : selectors) {
+    selector = Fold(context, std::move(selector));
+    kinds += ToInt64(selector).value_or(-1000);
+  }
+  std::chrono::duration<double> seconds{
+      std::chrono::steady_clock::now() - start};
+  std::size_t n{selectors.size()};
+  std::printf("%zu kind selectors: %.3fs, %.2fus each (%jd)\n", n,
+      seconds.count(), seconds.count() * 1e6 / n,
+      static_cast<std::intmax_t>(kinds));
+}
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+  if (argc > 1 && std::string{argv[1]} == "-benchmark") {
+    Fortran::evaluate::BenchmarkIntrinsicFolding();
+    return 0;
+  }
   Fortran::evaluate::TestIntrinsics();
+  Fortran::evaluate::TestIntrinsicFolding();
   return testing::Complete();
 }
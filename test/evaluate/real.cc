@@ -15,10 +15,13 @@
 #include "fp-testing.h"
 #include "testing.h"
 #include "../../lib/evaluate/type.h"
+#include <charconv>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <type_traits>
+#include <vector>
 
 using namespace Fortran::evaluate;
 using namespace Fortran::common;
@@ -490,6 +493,138 @@ void subsetTests(int pass, Rounding rounding, std::uint32_t opds) {
   }
 }
 
+// Compares the results and flags of arithmetic performed with the host's
+// floating-point unit against those of the emulation, both for scalars and
+// for elementwise array operations with a broadcast first operand.
+template<typename UINT, typename REAL>
+void hostTest(int pass, Rounding rounding, std::uint32_t opds) {
+  using ArrayOperation = RealFlags (*)(const REAL *, std::size_t,
+      const REAL *, std::size_t, REAL *, std::size_t, Rounding);
+  static constexpr ArrayOperation arrayOperations[4]{REAL::AddElementwise,
+      REAL::SubtractElementwise, REAL::MultiplyElementwise,
+      REAL::DivideElementwise};
+  std::uint64_t seed{static_cast<std::uint64_t>(pass)};
+  std::vector<REAL> ys, expected[4];
+  for (UINT j{0}; j < opds; ++j) {
+    UINT rj;
+    if (j < opds / 2) {
+      rj = MakeReal(j);
+    } else {
+      seed = seed * 6364136223846793005 + 1442695040888963407;
+      rj = seed >> (64 - 8 * sizeof(UINT));
+    }
+    REAL x{typename REAL::Word{std::uint64_t{rj}}};
+    ys.clear();
+    RealFlags expectedFlags[4];
+    for (int op{0}; op < 4; ++op) {
+      expected[op].clear();
+    }
+    for (UINT k{0}; k < opds; ++k) {
+      UINT rk;
+      if (k < opds / 2) {
+        rk = MakeReal(k);
+      } else {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        rk = seed >> (64 - 8 * sizeof(UINT));
+      }
+      REAL y{typename REAL::Word{std::uint64_t{rk}}};
+      ValueWithRealFlags<REAL> host[4], emulated[4];
+      for (bool useHost : {false, true}) {
+        value::useHostFloatingPoint = useHost;
+        auto *result{useHost ? host : emulated};
+        result[0] = x.Add(y, rounding);
+        result[1] = x.Subtract(y, rounding);
+        result[2] = x.Multiply(y, rounding);
+        result[3] = x.Divide(y, rounding);
+      }
+      for (int op{0}; op < 4; ++op) {
+        MATCH(emulated[op].value.RawBits().ToUInt64(),
+            host[op].value.RawBits().ToUInt64())
+        ("%d 0x%llx %c 0x%llx", pass, static_cast<long long>(rj), "+-*/"[op],
+            static_cast<long long>(rk));
+        TEST(emulated[op].flags == host[op].flags)
+        ("%d 0x%llx %c 0x%llx", pass, static_cast<long long>(rj), "+-*/"[op],
+            static_cast<long long>(rk));
+        expected[op].push_back(emulated[op].value);
+        expectedFlags[op] |= emulated[op].flags;
+      }
+      ys.push_back(y);
+    }
+    std::vector<REAL> results(ys.size());
+    for (int op{0}; op < 4; ++op) {
+      RealFlags flags{arrayOperations[op](
+          &x, 0, ys.data(), 1, results.data(), ys.size(), rounding)};
+      for (std::size_t k{0}; k < ys.size(); ++k) {
+        MATCH(expected[op][k].RawBits().ToUInt64(),
+            results[k].RawBits().ToUInt64())
+        ("%d 0x%llx %c [%zd]", pass, static_cast<long long>(rj), "+-*/"[op],
+            k);
+      }
+      TEST(flags == expectedFlags[op])
+      ("%d 0x%llx %c array", pass, static_cast<long long>(rj), "+-*/"[op]);
+    }
+  }
+}
+
+// Checks decimal conversions of normal numbers against the host's
+// strtod() and printf().
+template<typename UINT, typename FLT, typename REAL>
+void decimalTest(int maxDecimalExponent, std::uint32_t opds) {
+  std::uint64_t seed{1};
+  for (std::uint32_t j{0}; j < 64 * opds; ++j) {
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    int length = 1 + (seed >> 59) % 18;  // plus one fractional digit
+    std::uint64_t significand{(seed >> 1) % 1000000000000000000u};
+    for (int k{length}; k < 18; ++k) {
+      significand /= 10;
+    }
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    int exponent = static_cast<int>((seed >> 33) % (2 * maxDecimalExponent)) -
+        maxDecimalExponent - length;  // keep the magnitude in range
+    char buffer[64];
+    std::snprintf(buffer, sizeof buffer, "%c%llu.%dE%d", "+-"[j & 1],
+        static_cast<unsigned long long>(significand), (j >> 1) % 10,
+        exponent);
+    const char *p{buffer};
+    auto read{REAL::Read(p)};
+    TEST(*p == '\0')("%s", buffer);
+    FLT f;
+    if constexpr (std::is_same_v<FLT, float>) {
+      f = std::strtof(buffer, nullptr);
+    } else {
+      f = std::strtod(buffer, nullptr);
+    }
+    UINT raw;
+    std::memcpy(&raw, &f, sizeof raw);
+    MATCH(raw, read.value.RawBits().ToUInt64())("%s", buffer);
+
+    // The shortest representation that reads back to the same value
+    auto scaled{read.value.ABS().AsScaledDecimal()};
+    f = std::abs(f);
+    for (int precision{1};; ++precision) {
+      std::snprintf(buffer, sizeof buffer, "%.*e", precision - 1, f);
+      FLT readBack;
+      if constexpr (std::is_same_v<FLT, float>) {
+        readBack = std::strtof(buffer, nullptr);
+      } else {
+        readBack = std::strtod(buffer, nullptr);
+      }
+      if (readBack == f) {
+        break;
+      }
+    }
+    char *e{std::strchr(buffer, 'e')};
+    int decimalExponent = std::atoi(e + 1);
+    std::string digits{buffer, e};
+    if (digits.size() > 1) {
+      digits.erase(1, 1);  // '.'
+      decimalExponent -= digits.size() - 1;
+    }
+    MATCH(digits.c_str(), scaled.value.integer.UnsignedDecimal())("%s", buffer);
+    MATCH(decimalExponent, scaled.value.decimalExponent)("%s", buffer);
+  }
+}
+
 void roundTest(int rm, Rounding rounding, std::uint32_t opds) {
   basicTests<Real2>(rm, rounding);
   basicTests<Real4>(rm, rounding);
@@ -499,6 +634,10 @@ void roundTest(int rm, Rounding rounding, std::uint32_t opds) {
   ScopedHostFloatingPointEnvironment::SetRounding(rounding);
   subsetTests<std::uint32_t, float, Real4>(rm, rounding, opds);
   subsetTests<std::uint64_t, double, Real8>(rm, rounding, opds);
+  if (rounding == Rounding::TiesToEven) {
+    hostTest<std::uint32_t, Real4>(rm, rounding, opds);
+    hostTest<std::uint64_t, Real8>(rm, rounding, opds);
+  }
 }
 
 int main() {
@@ -508,6 +647,10 @@ int main() {
     // Use 8192 or 16384 for more exhaustive testing.
     opds = std::atol(p);
   }
+#if __cpp_lib_to_chars >= 201611L
+  decimalTest<std::uint32_t, float, Real4>(30, opds);
+  decimalTest<std::uint64_t, double, Real8>(290, opds);
+#endif
   roundTest(0, Rounding::TiesToEven, opds);
   roundTest(1, Rounding::ToZero, opds);
   roundTest(2, Rounding::Up, opds);
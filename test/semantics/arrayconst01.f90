@@ -0,0 +1,38 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+
+! Array constructors in specification expressions are analyzed and folded,
+! along with operations and intrinsic function references on their values.
+
+! RUN: ${F18} -fparse-only -fdebug-dump-symbols %s 2>&1 | ${FileCheck} %s
+! CHECK: a, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:5_8$
+! CHECK: b, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:4_8$
+! CHECK: c, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:12_8$
+! CHECK: d, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:3_8$
+! CHECK: f, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:5_8$
+! CHECK: g, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:7_4$
+! CHECK: array constructor is too large to fold
+! CHECK-NOT: error
+
+module marray1
+  integer, parameter :: n = 5
+  real :: a(size([(j, j=1,n)]))
+  real :: b(size([(j, j=10,1,2-5)]))
+  real :: c(size([((j + k, k=1,3), j=1,4)]))
+  real :: d(size([1, 2, 3] * 2))
+  real :: e(size([(j, j=1,huge(0))]))
+  real :: f(size([(j, j=1,n)] + [(2*j, j=1,n)]))
+  real :: g(max(n, abs(2-9)))
+end
@@ -0,0 +1,51 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! Dependence scanning with -M
+
+! RUN: ${F18} -M %s 2>&1 | ${FileCheck} %s
+! CHECK: depend01.o m1.mod m1-sub1.mod:
+! CHECK: m0.mod
+! CHECK: m2.mod
+! CHECK: m1-sub0.mod
+! CHECK: m3.mod
+! CHECK-NOT: iso_c_binding.mod
+! CHECK-NOT: hidden.mod
+! CHECK-NOT: foo.mod
+! CHECK-NOT: bar.mod
+
+module m1
+  use, intrinsic :: iso_c_binding
+  use m0; use :: m2, only: x
+  interface
+    module subroutine s
+    end subroutine
+  end interface
+  integer :: user = 1
+  character(len=*), parameter :: c = 'use foo; module bar'
+#ifdef NEVER
+  use hidden
+#endif
+end module m1
+
+submodule (m1:sub0) sub1
+  use, non_intrinsic :: m3
+contains
+  module procedure s
+  end procedure
+end submodule
+
+program p
+  use m1
+end
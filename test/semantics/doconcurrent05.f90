@@ -0,0 +1,34 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! With -fdebug-expressions, expressions are analyzed in the same traversal
+! as the DO CONCURRENT checks, so they are analyzed even when those checks
+! fail; module files are written only after both, and only if neither
+! found an error.
+
+! RUN: d=$(mktemp -d) && ${F18} -fparse-only -fdebug-expressions -module $d %s > $d/out 2>&1; ls $d >> $d/out; ${FileCheck} %s < $d/out; r=$?; rm -rf $d; exit $r
+! CHECK: RETURN not allowed in DO CONCURRENT
+! CHECK: ^checked expression: .2_4.n.$
+! CHECK-NOT: m.mod
+
+module m
+contains
+  subroutine s(n)
+    integer :: n, i, j
+    j = 2 * n
+    do concurrent (i = 1:n)
+      return
+    end do
+  end subroutine
+end module
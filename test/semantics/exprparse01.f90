@@ -0,0 +1,52 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! Precedence and associativity of intrinsic and defined operators
+
+! RUN: ${F18} -fparse-only -fdebug-dump-parse-tree %s 2>&1 | ${FileCheck} %s
+! CHECK: ^[|] [|] [|] Expr -> Subtract$
+! CHECK: ^[|] [|] [|] [|] Expr -> Subtract$
+! CHECK: ^[|] [|] [|] Expr -> Negate -> Expr -> Power$
+! CHECK: ^[|] [|] [|] [|] Expr -> Power$
+! CHECK: ^[|] [|] [|] Expr -> Divide$
+! CHECK: ^[|] [|] [|] [|] Expr -> Multiply$
+! CHECK: ^[|] [|] [|] [|] [|] Expr -> Negate -> Expr -> Designator -> DataRef -> Name = 'c'$
+! CHECK: ^[|] [|] [|] Expr -> NEQV$
+! CHECK: ^[|] [|] [|] [|] Expr -> EQV$
+! CHECK: ^[|] [|] [|] [|] [|] Expr -> OR$
+! CHECK: ^[|] [|] [|] [|] [|] [|] Expr -> AND$
+! CHECK: ^[|] [|] [|] [|] [|] [|] [|] Expr -> LT$
+! CHECK: ^[|] [|] [|] [|] [|] [|] [|] Expr -> NOT -> Expr -> NOT -> Expr -> Designator -> DataRef -> Name = 'm'$
+! CHECK: ^[|] [|] [|] Expr -> AND$
+! CHECK: ^[|] [|] [|] [|] Expr -> LT$
+! CHECK: ^[|] [|] [|] [|] [|] Expr -> Concat$
+! CHECK: ^[|] [|] [|] [|] Expr -> NE$
+! CHECK: ^[|] [|] [|] Expr -> DefinedBinary$
+! CHECK: ^[|] [|] [|] [|] Expr -> DefinedBinary$
+! CHECK: ^[|] [|] [|] [|] [|] Expr -> Add$
+! CHECK: ^[|] [|] [|] [|] Expr -> AND$
+! CHECK-NOT: Expr -> Negate -> Expr -> Designator -> DataRef -> Name = 'b'
+
+subroutine s(a, b, c, d, l, m, n, ch)
+  real :: a, b, c, d
+  logical :: l, m, n
+  character(*) :: ch
+  a = b - c - d
+  a = -b ** c ** d
+  a = b * -c / d
+  l = a < b .and. .not. .not. m .or. n .eqv. l .neqv. m
+  l = ch // ch < ch .and. a /= b
+  a = b .op. c + d .op. a
+  l = l .and. m .op. n
+end subroutine
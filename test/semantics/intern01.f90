@@ -0,0 +1,29 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! -fintern-expressions must not change module files or symbols.
+
+! RUN: d=$(mktemp -d) && mkdir $d/a $d/b && ${F18} -fparse-only -fdebug-dump-symbols -module $d/a %s > $d/a.symbols && ${F18} -fparse-only -fdebug-dump-symbols -fintern-expressions -module $d/b %s > $d/b.symbols && diff $d/a.symbols $d/b.symbols && diff -r $d/a $d/b && cat $d/b.symbols $d/b/mintern1.mod | ${FileCheck} %s; r=$?; rm -rf $d; exit $r
+! CHECK: a, PUBLIC: ObjectEntity type: REAL.4. shape: 1_8:4_4 1_8:8_4$
+! CHECK: ^real.4.::b.1_8:4_4,1_8:8_4.$
+
+module mintern1
+  integer, parameter :: n = 4
+  real :: a(n, 2*n), b(n, 2*n)
+  integer(8) :: x(0:n-1), y(0:n-1)
+contains
+  subroutine s(u, v)
+    real :: u(n, n+1), v(n, n+1)
+  end
+end
@@ -0,0 +1,33 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! -fdebug-dump-parse-tree-json writes one JSON object per node, with its depth,
+! name, and value, and escapes quotation marks, backslashes, control
+! characters, and bytes that aren't valid UTF-8 in the values.
+
+! RUN: ${F18} -fparse-only -fdebug-dump-parse-tree-json %s | ${FileCheck} %s
+! CHECK: ^."depth":0,"node":"Program".$
+! CHECK: ^."depth":2,"node":"MainProgram".$
+! CHECK: ^."depth":3,"node":"ProgramStmt".$
+! CHECK: ^."depth":4,"node":"Name","value":"json01".$
+! CHECK: ^."depth":16,"node":"int","value":8.$
+! CHECK: ^."depth":12,"node":"Name","value":"a."b..c.u0009z".$
+! CHECK: ^."depth":12,"node":"Name","value":"caf(.u00[0-9a-f][0-9a-f])+".$
+! CHECK-NOT: [^ -~]
+
+program json01
+  character(8) :: x, y
+  x = 'a"b\c	z'
+  y = 'café'
+end
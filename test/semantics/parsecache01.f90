@@ -0,0 +1,42 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! Saving and reloading a parse tree with -fparse-tree-cache
+
+! RUN: d=$(mktemp -d) && ${F18} -fparse-only -fparse-tree-cache $d %s && ${F18} -funparse -v -fparse-tree-cache $d %s 2>&1 | ${FileCheck} %s; r=$?; rm -rf $d; exit $r
+! CHECK: reloaded the parse tree of .*parsecache01.f90 from
+! CHECK: MODULE m
+! CHECK: REAL.KIND=8. :: x = 1.5_8
+! CHECK: x = x.*.y.2.d0.
+! CHECK: 1 FORMAT.X,"x = ",F8.3.
+! CHECK: CHARACTER.LEN=... PARAMETER :: s = "a 'quoted' string"
+! CHECK: 10 DO j=1,n,2
+! CHECK: END SUBROUTINE
+
+module m
+  real(8) :: x = 1.5_8
+ contains
+  subroutine s1(y, n)
+    real(8), intent(in) :: y
+    integer :: n, j
+    character(*), parameter :: s = "a 'quoted' string"
+    x = x * (y + 2.d0)
+    write(*, 1) x
+1   format(1x, 'x = ', f8.3)
+10  do j = 1, n, &
+      2
+      x = x + j
+    end do
+  end subroutine
+end module
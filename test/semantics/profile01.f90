@@ -0,0 +1,29 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! -fdebug-profile-parse lists each profiled production once, with its
+! times, attempts, successes, and backtracked characters.
+
+! RUN: d=$(mktemp -d) && ${F18} -fdebug-profile-parse %s > $d/profile && test -z "$(sed 1d $d/profile | cut -d' ' -f6- | sort | uniq -d)" && (head -1 $d/profile; sed 1d $d/profile | LC_ALL=C sort -k6) | ${FileCheck} %s; r=$?; rm -rf $d; exit $r
+! CHECK: ^self.us. total.us. attempts successes backtracked production$
+! CHECK: ^[0-9]+ [0-9]+ [0-9]+ [1-9][0-9]* [0-9]+ SUBROUTINE subprogram$
+! CHECK: ^[0-9]+ [0-9]+ [0-9]+ [1-9][0-9]* [0-9]+ assignment statement$
+
+subroutine profile01(x, n)
+  real :: x(n)
+  do i = 1, n
+    x(i) = x(i) * 2
+  end do
+  n = 0
+end subroutine
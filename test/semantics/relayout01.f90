@@ -0,0 +1,39 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! -frelayout-parse-tree moves the nodes of the parse tree but must not
+! change it; -fdebug-measure-parse-tree reports its traversal time before
+! and after.
+
+! RUN: d=$(mktemp -d) && ${F18} -funparse %s > $d/before && ${F18} -funparse -frelayout-parse-tree -fdebug-measure-parse-tree %s > $d/after && grep -v '^Parse tree comprises\|^Traversing it took' $d/after | diff $d/before - && ${FileCheck} %s < $d/after; r=$?; rm -rf $d; exit $r
+! CHECK: ^Parse tree comprises [0-9]+ objects and occupies [0-9]+ total bytes.$
+! CHECK: ^Traversing it took [0-9.e+-]+ microseconds.$
+
+module m
+  type :: t
+    real, allocatable :: a(:)
+  end type
+contains
+  subroutine s(x, n)
+    type(t) :: x(n)
+    integer :: n, j
+    do j = 1, n
+      if (allocated(x(j)%a)) then
+        x(j)%a = 2.0 * x(j)%a + 1.0
+      else
+        allocate(x(j)%a(n))
+      end if
+    end do
+  end subroutine
+end module
@@ -0,0 +1,38 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! Reparsing an edited source file with -fdebug-reparse must produce the
+! same parse tree as parsing the edited file from scratch.
+
+! RUN: d=$(mktemp -d) && sed -e 's/n = 2$/n = 2000 + n/' %s > $d/edited.f90 && ${F18} -fparse-only -funparse -v -fdebug-reparse $d/edited.f90 %s > $d/reparsed 2> $d/log && ${F18} -fparse-only -funparse $d/edited.f90 | diff - $d/reparsed && ${F18} -fparse-only -fdebug-dump-parse-tree -fdebug-reparse $d/edited.f90 %s > $d/dumped && ${F18} -fparse-only -fdebug-dump-parse-tree $d/edited.f90 | diff - $d/dumped && cat $d/log $d/reparsed | ${FileCheck} %s; r=$?; rm -rf $d; exit $r
+! CHECK: ^reparsed program units .1, 2. of 3$
+! CHECK: ^ n = 2000.n$
+
+module m
+  integer :: n = 1
+end module
+
+subroutine s(x)
+  use m
+  real :: x(n)
+  n = 2
+  x = n
+end subroutine
+
+program main
+  use m
+  real :: y(10)
+  call s(y)
+  print *, y(1)
+end program
@@ -0,0 +1,24 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! Reparsing a source file whose cooked character stream is short must
+! still find the program units that did not change, and must release the
+! provenances of the previous prescan rather than allocating more.
+
+! RUN: d=$(mktemp -d) && sed -e '0,/^end$/s//stop; end/' %s > $d/edited.f90 && ${F18} -fparse-only -funparse -v -fdebug-reparse $d/edited.f90 %s > $d/reparsed 2> $d/log && ${F18} -fparse-only -funparse $d/edited.f90 | diff - $d/reparsed && ${F18} -fdebug-dump-provenance -fdebug-reparse $d/edited.f90 %s | grep -v '"' > $d/provenance && ${F18} -fdebug-dump-provenance $d/edited.f90 | grep -v '"' | diff - $d/provenance && cat $d/log $d/reparsed | ${FileCheck} %s; r=$?; rm -rf $d; exit $r
+! CHECK: ^reparsed program units .0, 1. of 2$
+! CHECK: ^ STOP$
+
+end
+end
@@ -0,0 +1,28 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+
+! CHARACTER(KIND=2) and (KIND=4) literals are decoded from UTF-8.
+
+! RUN: ${F18} -fparse-only -fdebug-expressions %s 2>&1 | ${FileCheck} %s
+! CHECK: ^checked expression: 4_"a.303.251.342.202.254.360.235.204.236"$
+! CHECK: ^checked expression: 4_".337.237.340.240.200.357.277.277"$
+! CHECK: ^checked expression: 2_".303.251.342.202.254"$
+! CHECK-NOT: bad UTF-8
+
+program main
+  print *, 4_'aé€𝄞'
+  print *, 4_'ߟࠀ￿'
+  print *, 2_'é€'
+end program
@@ -0,0 +1,65 @@
+! Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+
+! Unparsing program units on several threads with -funparse-threads must
+! produce the same output, byte for byte, as unparsing them in sequence.
+
+! RUN: d=$(mktemp -d) && ${F18} -fparse-only -funparse %s > $d/sequential && ${F18} -fparse-only -funparse -funparse-threads 4 %s > $d/parallel && cmp $d/sequential $d/parallel && ${F18} -fparse-only -funparse -funparse-threads 64 %s | cmp $d/sequential - && cat $d/parallel | ${FileCheck} %s; r=$?; rm -rf $d; exit $r
+! CHECK: ^MODULE unparse01m$
+! CHECK: ^SUBROUTINE s1$
+! CHECK: ^SUBROUTINE s6$
+! CHECK: ^PROGRAM unparse01$
+
+module unparse01m
+  integer, parameter :: k = 4
+contains
+  subroutine m1(x)
+    real(k) :: x
+    x = x * 2
+  end subroutine
+end module
+subroutine s1
+  do i = 1, 10
+    print *, i
+  end do
+end subroutine
+subroutine s2(a, n)
+  integer :: n
+  real :: a(n)
+  where (a > 0) a = -a
+end subroutine
+function s3(x) result(y)
+  y = x + 1
+end function
+subroutine s4
+  character(len=5) :: c = 'abc'
+  print *, c
+end subroutine
+block data s5
+  common /c5/ i5
+  data i5 /5/
+end block data
+subroutine s6
+  if (.true.) then
+    call s1
+  else
+    stop
+  end if
+end subroutine
+program unparse01
+  use unparse01m
+  real :: r = 1.5
+  call m1(r)
+  call s6
+end program
@@ -15,8 +15,10 @@
 // Temporary Fortran front end driver main program for development scaffolding.
 
 #include "../../lib/parser/characters.h"
+#include "../../lib/parser/dependences.h"
 #include "../../lib/parser/features.h"
 #include "../../lib/parser/message.h"
+#include "../../lib/parser/parse-tree-layout.h"
 #include "../../lib/parser/parse-tree-visitor.h"
 #include "../../lib/parser/parse-tree.h"
 #include "../../lib/parser/parsing.h"
@@ -28,9 +30,11 @@
 #include "../../lib/semantics/semantics.h"
 #include "../../lib/semantics/unparse-with-symbols.h"
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -60,9 +64,13 @@ struct MeasurementVisitor {
 
 void MeasureParseTree(const Fortran::parser::Program &program) {
   MeasurementVisitor visitor;
+  auto start{std::chrono::steady_clock::now()};
   Fortran::parser::Walk(program, visitor);
+  std::chrono::duration<double, std::micro> elapsed{
+      std::chrono::steady_clock::now() - start};
   std::cout << "Parse tree comprises " << visitor.objects
             << " objects and occupies " << visitor.bytes << " total bytes.\n";
+  std::cout << "Traversing it took " << elapsed.count() << " microseconds.\n";
 }
 
 std::vector<std::string> filesToDelete;
@@ -88,14 +96,24 @@ struct DriverOptions {
   bool parseOnly{false};
   bool dumpProvenance{false};
   bool dumpCookedChars{false};
+  bool dumpDependences{false};  // -M
+  std::string dependencesPath;  // -MF path
+  std::string parseTreeCacheDirectory;  // -fparse-tree-cache dir
+  std::string reparsePath;  // -fdebug-reparse path
   bool dumpUnparse{false};
+  int unparseThreads{1};  // -funparse-threads n
   bool dumpUnparseWithSymbols{false};
   bool dumpParseTree{false};
+  Fortran::semantics::DumpTreeFormat parseTreeDumpFormat{
+      Fortran::semantics::DumpTreeFormat::Text};
   bool dumpSymbols{false};
   bool debugExpressions{false};
+  bool internExpressions{false};  // -fintern-expressions
+  bool debugFoldStatistics{false};  // -fdebug-fold-statistics
   bool debugResolveNames{false};
   bool debugSemantics{false};
   bool measureTree{false};
+  bool relayoutTree{false};  // -frelayout-parse-tree
   std::vector<std::string> pgf90Args;
   const char *prefix{nullptr};
 };
@@ -157,8 +175,67 @@ std::string RelocatableName(const DriverOptions &driver, std::string path) {
   return relo;
 }
 
+// Module file paths are formed as they are in semantics/mod-file.cc.
+std::string ModuleFilePath(
+    const DriverOptions &driver, const std::string &name) {
+  if (driver.moduleDirectory == "."s) {
+    return name + ".mod";
+  } else {
+    return driver.moduleDirectory + '/' + name + ".mod";
+  }
+}
+
+std::string EscapeMakePath(const std::string &path) {
+  std::string result;
+  for (char ch : path) {
+    if (ch == ' ' || ch == '#') {
+      result += '\\';
+    } else if (ch == '$') {
+      result += '$';
+    }
+    result += ch;
+  }
+  return result;
+}
+
+// Writes a make rule, also acceptable to ninja as a depfile, whose targets
+// are the relocatable and any module files that the source file produces.
+void WriteDependences(std::ostream &o, const std::string &path,
+    const Fortran::parser::Dependences &deps, const DriverOptions &driver) {
+  o << EscapeMakePath(RelocatableName(driver, path));
+  for (const auto &name : deps.providedModules) {
+    o << ' ' << EscapeMakePath(ModuleFilePath(driver, name));
+  }
+  o << ':';
+  auto prerequisite{[&](const std::string &file) {
+    o << " \\\n  " << EscapeMakePath(file);
+  }};
+  prerequisite(path);
+  for (const auto &file : deps.includedFiles) {
+    prerequisite(file);
+  }
+  for (const auto &name : deps.requiredModules) {
+    prerequisite(ModuleFilePath(driver, name));
+  }
+  o << '\n';
+}
+
 int exitStatus{EXIT_SUCCESS};
 
+// Saved parse trees are named after their source files, qualified by
+// a hash of the whole path so that like-named sources don't collide.
+std::string ParseTreeCachePath(
+    const std::string &path, const DriverOptions &driver) {
+  std::string name{path};
+  if (auto slash{name.rfind('/')}; slash != std::string::npos) {
+    name = name.substr(slash + 1);
+  }
+  char hash[17];
+  std::snprintf(hash, sizeof hash, "%016llx",
+      static_cast<unsigned long long>(std::hash<std::string>{}(path)));
+  return driver.parseTreeCacheDirectory + '/' + name + '-' + hash + ".ptree";
+}
+
 std::string CompileFortran(std::string path, Fortran::parser::Options options,
     DriverOptions &driver,
     Fortran::semantics::SemanticsContext &semanticsContext) {
@@ -171,7 +248,23 @@ std::string CompileFortran(std::string path, Fortran::parser::Options options,
   }
   options.searchDirectories = driver.searchDirectories;
   Fortran::parser::Parsing parsing;
-  parsing.Prescan(path, options);
+  std::string cachePath;
+  if (!driver.parseTreeCacheDirectory.empty() && path != "-" &&
+      !options.instrumentedParse && !options.profileParse) {
+    cachePath = ParseTreeCachePath(path, driver);
+  }
+  bool reloaded{false};
+  if (!cachePath.empty()) {
+    std::ifstream cached{cachePath, std::ios::binary};
+    reloaded = cached && parsing.LoadParseTree(cached, options);
+    if (reloaded && driver.verbose) {
+      std::cerr << "reloaded the parse tree of " << path << " from "
+                << cachePath << '\n';
+    }
+  }
+  if (!reloaded) {
+    parsing.Prescan(path, options);
+  }
   if (!parsing.messages().empty() &&
       (driver.warningsAreErrors || parsing.messages().AnyFatalError())) {
     std::cerr << driver.prefix << "could not scan " << path << '\n';
@@ -179,7 +272,7 @@ std::string CompileFortran(std::string path, Fortran::parser::Options options,
     exitStatus = EXIT_FAILURE;
     return {};
   }
-  if (driver.dumpProvenance) {
+  if (driver.dumpProvenance && driver.reparsePath.empty()) {
     parsing.DumpProvenance(std::cout);
     return {};
   }
@@ -187,12 +280,28 @@ std::string CompileFortran(std::string path, Fortran::parser::Options options,
     parsing.DumpCookedChars(std::cout);
     return {};
   }
-  parsing.Parse(&std::cout);
-  if (options.instrumentedParse) {
-    parsing.DumpParsingLog(std::cout);
+  if (driver.dumpDependences) {
+    auto deps{Fortran::parser::ScanDependences(parsing.cooked())};
+    if (driver.dependencesPath.empty()) {
+      WriteDependences(std::cout, path, deps, driver);
+    } else {
+      std::ofstream depfile{driver.dependencesPath, std::ios::app};
+      WriteDependences(depfile, path, deps, driver);
+    }
     return {};
   }
-  parsing.ClearLog();
+  if (!reloaded) {
+    parsing.Parse(&std::cout);
+    if (options.instrumentedParse) {
+      parsing.DumpParsingLog(std::cout);
+      return {};
+    }
+    if (options.profileParse) {
+      parsing.DumpParsingProfile(std::cout);
+      return {};
+    }
+    parsing.ClearLog();
+  }
   parsing.messages().Emit(std::cerr, parsing.cooked());
   if (!parsing.consumedWholeFile()) {
     parsing.EmitMessage(
@@ -207,17 +316,55 @@ std::string CompileFortran(std::string path, Fortran::parser::Options options,
     exitStatus = EXIT_FAILURE;
     return {};
   }
+  if (!cachePath.empty() && !reloaded && parsing.messages().empty()) {
+    std::ofstream cache{cachePath, std::ios::binary};
+    if (!cache || !parsing.SaveParseTree(cache)) {
+      std::cerr << driver.prefix << "could not save the parse tree of "
+                << path << " in " << cachePath << '\n';
+    }
+  }
+  if (!driver.reparsePath.empty()) {
+    // Reparse an edited copy of the source file in place of the original,
+    // as an editor would.
+    auto [first, last]{parsing.Reparse(driver.reparsePath, options)};
+    parsing.messages().Emit(std::cerr, parsing.cooked());
+    if (parsing.messages().AnyFatalError() ||
+        !parsing.parseTree().has_value()) {
+      std::cerr << driver.prefix << "could not reparse "
+                << driver.reparsePath << '\n';
+      exitStatus = EXIT_FAILURE;
+      return {};
+    }
+    if (driver.verbose) {
+      std::cerr << "reparsed program units [" << first << ", " << last
+                << ") of " << parsing.parseTree()->v.size() << '\n';
+    }
+    if (driver.dumpProvenance) {
+      parsing.DumpProvenance(std::cout);
+      return {};
+    }
+  }
   auto &parseTree{*parsing.parseTree()};
+  if (driver.relayoutTree) {
+    if (driver.measureTree) {
+      MeasureParseTree(parseTree);  // for comparison
+    }
+    Fortran::parser::RelayoutParseTree(parseTree);
+  }
   if (driver.measureTree) {
     MeasureParseTree(parseTree);
   }
   // TODO: Change this predicate to just "if (!driver.debugNoSemantics)"
   if (driver.debugSemantics || driver.debugResolveNames || driver.dumpSymbols ||
-      driver.dumpUnparseWithSymbols || driver.debugExpressions) {
+      driver.dumpUnparseWithSymbols || driver.debugExpressions ||
+      driver.debugFoldStatistics) {
     Fortran::semantics::Semantics semantics{
         semanticsContext, parseTree, parsing.cooked()};
     semantics.Perform();
     semantics.EmitMessages(std::cerr);
+    if (driver.debugFoldStatistics) {
+      semanticsContext.foldCache().Dump(std::cerr);
+    }
     if (driver.dumpSymbols) {
       semantics.DumpSymbols(std::cout);
     }
@@ -233,12 +380,19 @@ std::string CompileFortran(std::string path, Fortran::parser::Options options,
     }
   }
   if (driver.dumpParseTree) {
-    Fortran::semantics::DumpTree(std::cout, parseTree);
+    Fortran::semantics::DumpTree(
+        std::cout, parseTree, driver.parseTreeDumpFormat);
   }
   if (driver.dumpUnparse) {
-    Unparse(std::cout, parseTree, driver.encoding, true /*capitalize*/,
-        options.features.IsEnabled(
-            Fortran::parser::LanguageFeature::BackslashEscapes));
+    bool backslashEscapes{options.features.IsEnabled(
+        Fortran::parser::LanguageFeature::BackslashEscapes)};
+    if (driver.unparseThreads > 1) {
+      UnparseInParallel(std::cout, parseTree, driver.unparseThreads,
+          driver.encoding, true /*capitalize*/, backslashEscapes);
+    } else {
+      Unparse(std::cout, parseTree, driver.encoding, true /*capitalize*/,
+          backslashEscapes);
+    }
     return {};
   }
   if (driver.parseOnly) {
@@ -380,6 +534,17 @@ int main(int argc, char *const argv[]) {
       options.features.Enable(Fortran::parser::LanguageFeature::OldDebugLines);
     } else if (arg == "-E") {
       driver.dumpCookedChars = true;
+    } else if (arg == "-M") {
+      driver.dumpDependences = true;
+    } else if (arg == "-MF") {
+      driver.dependencesPath = args.front();
+      args.pop_front();
+    } else if (arg == "-fparse-tree-cache") {
+      driver.parseTreeCacheDirectory = args.front();
+      args.pop_front();
+    } else if (arg == "-fdebug-reparse") {
+      driver.reparsePath = args.front();
+      args.pop_front();
     } else if (arg == "-fbackslash") {
       options.features.Enable(
           Fortran::parser::LanguageFeature::BackslashEscapes);
@@ -390,21 +555,36 @@ int main(int argc, char *const argv[]) {
       driver.dumpProvenance = true;
     } else if (arg == "-fdebug-dump-parse-tree") {
       driver.dumpParseTree = true;
+    } else if (arg == "-fdebug-dump-parse-tree-json") {
+      driver.dumpParseTree = true;
+      driver.parseTreeDumpFormat =
+          Fortran::semantics::DumpTreeFormat::JSONLines;
     } else if (arg == "-fdebug-dump-symbols") {
       driver.dumpSymbols = true;
     } else if (arg == "-fdebug-expressions") {
       driver.debugExpressions = true;
+    } else if (arg == "-fintern-expressions") {
+      driver.internExpressions = true;
+    } else if (arg == "-fdebug-fold-statistics") {
+      driver.debugFoldStatistics = true;
     } else if (arg == "-fdebug-resolve-names") {
       driver.debugResolveNames = true;
     } else if (arg == "-fdebug-measure-parse-tree") {
       driver.measureTree = true;
+    } else if (arg == "-frelayout-parse-tree") {
+      driver.relayoutTree = true;
     } else if (arg == "-fdebug-instrumented-parse") {
       options.instrumentedParse = true;
+    } else if (arg == "-fdebug-profile-parse") {
+      options.profileParse = true;
     } else if (arg == "-fdebug-semantics") {
       // TODO: Enable by default once basic tests pass
       driver.debugSemantics = true;
     } else if (arg == "-funparse") {
       driver.dumpUnparse = true;
+    } else if (arg == "-funparse-threads") {
+      driver.unparseThreads = std::atoi(args.front().c_str());
+      args.pop_front();
     } else if (arg == "-funparse-with-symbols") {
       driver.dumpUnparseWithSymbols = true;
     } else if (arg == "-fparse-only") {
@@ -444,16 +624,32 @@ int main(int argc, char *const argv[]) {
           << "  -Werror              treat warnings as errors\n"
           << "  -ed                  enable fixed form D lines\n"
           << "  -E                   prescan & preprocess only\n"
+          << "  -M                   prescan & write make dependences only\n"
+          << "  -MF path             write dependences to path, not stdout\n"
           << "  -fparse-only         parse only, no output except messages\n"
           << "  -funparse            parse & reformat only, no code "
              "generation\n"
+          << "  -funparse-threads n  with -funparse, unparse program units "
+             "on n threads\n"
           << "  -funparse-with-symbols  parse, resolve symbols, and unparse\n"
+          << "  -fparse-tree-cache dir  save parse trees in dir and "
+             "reload them\n"
+          << "  -frelayout-parse-tree  lay out the parse tree for "
+             "faster traversals\n"
+          << "  -fintern-expressions  share one copy of each constant "
+             "bound, length, & kind\n"
           << "  -fdebug-measure-parse-tree\n"
+          << "  -fdebug-reparse path  reparse an edited copy of the "
+             "source from path\n"
           << "  -fdebug-dump-provenance\n"
           << "  -fdebug-dump-parse-tree\n"
+          << "  -fdebug-dump-parse-tree-json  one JSON object per node "
+             "and line\n"
           << "  -fdebug-dump-symbols\n"
+          << "  -fdebug-fold-statistics  report fold cache hit rates\n"
           << "  -fdebug-resolve-names\n"
           << "  -fdebug-instrumented-parse\n"
+          << "  -fdebug-profile-parse  count and time grammar productions\n"
           << "  -fdebug-semantics    perform semantic checks\n"
           << "  -v -c -o -I -D -U    have their usual meanings\n"
           << "  -help                print this again\n"
@@ -483,6 +679,10 @@ int main(int argc, char *const argv[]) {
   }
   driver.encoding = options.encoding;
 
+  if (!driver.dependencesPath.empty()) {
+    std::ofstream{driver.dependencesPath};  // truncate; sources append
+  }
+
   if (options.isStrictlyStandard) {
     options.features.WarnOnAllNonstandard();
   }
@@ -495,7 +695,8 @@ int main(int argc, char *const argv[]) {
   semanticsContext.set_moduleDirectory(driver.moduleDirectory)
       .set_searchDirectories(driver.searchDirectories)
       .set_warningsAreErrors(driver.warningsAreErrors)
-      .set_debugExpressions(driver.debugExpressions);
+      .set_debugExpressions(driver.debugExpressions)
+      .set_internExpressions(driver.internExpressions);
 
   if (!anyFiles) {
     driver.measureTree = true;